@@ -4,7 +4,7 @@
 #
 #-------------------------------------------------
 
-QT       += core gui
+QT       += core gui concurrent
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
@@ -14,59 +14,48 @@ TEMPLATE = app
 DEFINES += QT_DEPRECATED_WARNINGS
 win32: DEFINES += PLA_WINDOWS
 
+include(engine.pri)
+
 SOURCES += \
-    keysender.cpp \
+    assets.cpp \
+    clientwindow.cpp \
+    controlclient.cpp \
     wheeltab.cpp \
     thresholdsetter.cpp \
-    serial.cpp \
     programtab.cpp \
     profiletab.cpp \
-    profile.cpp \
     mainwindow.cpp \
     main.cpp \
     macrotab.cpp \
     macrorecorder.cpp \
-    macro.cpp \
+    joystickmap.cpp \
     keygrabber.cpp \
     colortab.cpp \
-    key.cpp \
-    input/controller.cpp \
-    input/joystick.cpp \
-    input/joysticktracker.cpp \
-    input/primaryjoysticktracker.cpp \
-    input/steeringtracker.cpp \
+    diagnosticsdialog.cpp \
+    lazytab.cpp \
     wheelthresholdsetter.cpp
 
 HEADERS += \
+    assets.h \
+    clientwindow.h \
     colortab.h \
-    config.h \
-    editing.h \
-    key.h \
+    controlclient.h \
+    diagnosticsdialog.h \
+    joystickmap.h \
     keygrabber.h \
-    keysender.h \
-    macro.h \
+    lazytab.h \
     macrorecorder.h \
     macrotab.h \
     mainwindow.h \
-    profile.h \
     profiletab.h \
     programtab.h \
     savabletab.h \
-    serial.h \
     thresholdsetter.h \
-    traymessage.h \
     wheeltab.h \
-    input/controller.h \
-    input/joystick.h \
-    input/joysticktracker.h \
-    input/primaryjoysticktracker.h \
-    input/steeringtracker.h \
     wheelthresholdsetter.h \
     runguard.h
 
-INCLUDEPATH += input
-
-unix:!macx: LIBS += -lwwwidgets5 -lxdo -lSDL2main -lSDL2
+unix:!macx: LIBS += -lwwwidgets5
 unix:!macx: QMAKE_CXXFLAGS += -Wall -Wextra -pedantic
 win32: LIBS += -L. -lwwwidgets5 -lSDL2 -lSDL2main -luser32 -lSetupAPI
 win32: RC_ICONS += ..\assets\icon.ico
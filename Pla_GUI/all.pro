@@ -0,0 +1,14 @@
+# Builds PLA_ALT and the headless PLA_ALTd, together with the benchmarks and
+# developer tools (Linux only). Open Pla_GUI.pro instead to build only the program.
+
+TEMPLATE = subdirs
+
+SUBDIRS += app daemon
+app.file = Pla_GUI.pro
+daemon.file = daemon/daemon.pro
+
+unix:!macx {
+    SUBDIRS += bench tools
+    bench.file = bench/bench.pro
+    tools.file = tools/tools.pro
+}
@@ -0,0 +1,80 @@
+#include "assets.h"
+#include "config.h"
+
+#include <QPixmapCache>
+#include <QThread>
+#include <QtConcurrent/QtConcurrent>
+
+#include <algorithm>
+
+QMutex Assets::lock;
+QCache<QString, QImage> Assets::images (config::AssetCacheLimit);
+
+// Every image that the GUI uses directly
+static const char *preloadList[] = {
+    "arrow.png",
+    "arrow-down.png",
+    "color-off.png",
+    "color-on.png",
+    "joystick.png",
+    "joystick-large.png",
+    "macro-down.png",
+    "macro-record.png",
+    "macro-trash.png",
+    "macro-up.png",
+    "wheelbg.png",
+};
+
+void Assets::preload(void)
+{
+    // Runs on a pool thread, which is handed back at its usual priority
+    QtConcurrent::run([] {
+        auto thread = QThread::currentThread();
+        auto priority = thread->priority();
+        thread->setPriority(QThread::IdlePriority);
+        for (auto name : preloadList)
+            image(name);
+        thread->setPriority(priority);
+    });
+}
+
+QImage Assets::image(const QString& name)
+{
+    {
+        QMutexLocker locker (&lock);
+        if (auto cached = images.object(name))
+            return *cached;
+    }
+
+    // Decode outside of the lock, so other assets can still be fetched
+    QImage decoded ("assets/" + name);
+    if (!decoded.isNull()) {
+        decoded = decoded.convertToFormat(decoded.hasAlphaChannel() ?
+            QImage::Format_ARGB32_Premultiplied : QImage::Format_RGB32);
+    }
+
+    QMutexLocker locker (&lock);
+    // Another thread may have beaten us to it
+    if (auto cached = images.object(name))
+        return *cached;
+    // (sizeInBytes() would need Qt 5.10)
+    images.insert(name, new QImage(decoded),
+        std::max(1, decoded.bytesPerLine() * decoded.height() / 1024));
+    return decoded;
+}
+
+QPixmap Assets::pixmap(const QString& name)
+{
+    QPixmap pix;
+    if (!QPixmapCache::find("assets/" + name, &pix)) {
+        pix = QPixmap::fromImage(image(name));
+        QPixmapCache::insert("assets/" + name, pix);
+    }
+
+    return pix;
+}
+
+QIcon Assets::icon(const QString& name)
+{
+    return QIcon(pixmap(name));
+}
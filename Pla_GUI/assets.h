@@ -0,0 +1,59 @@
+/**
+ * @file assets.h
+ * @brief Shared cache of the decoded images under assets/.
+ */
+#ifndef ASSETS_H
+#define ASSETS_H
+
+#include <QCache>
+#include <QIcon>
+#include <QImage>
+#include <QMutex>
+#include <QPixmap>
+#include <QString>
+
+/**
+ * @class Assets
+ * @brief Decodes each image in the assets folder once, and hands out shared
+ * copies of it.
+ *
+ * Images are decoded into the raster engine's native format, so turning them
+ * into pixmaps (and painting them) needs no further conversion. Returned
+ * pixmaps and icons are implicitly shared, so copies are cheap.
+ */
+class Assets {
+public:
+    /**
+     * Decodes all known assets on a low-priority background thread.
+     * Assets requested before this finishes are decoded on demand.
+     */
+    static void preload(void);
+
+    /**
+     * Gets the given asset as a pixmap.
+     * Must only be called from the GUI thread.
+     * @param name The asset's file name, e.g. "arrow.png"
+     */
+    static QPixmap pixmap(const QString& name);
+
+    /**
+     * Gets the given asset as an icon.
+     * Must only be called from the GUI thread.
+     * @param name The asset's file name, e.g. "arrow.png"
+     */
+    static QIcon icon(const QString& name);
+
+    /**
+     * Gets the given asset's decoded image. Safe to call from any thread.
+     * @param name The asset's file name, e.g. "arrow.png"
+     */
+    static QImage image(const QString& name);
+
+private:
+    // Guards images
+    static QMutex lock;
+    // Decoded images, with costs in kilobytes
+    static QCache<QString, QImage> images;
+};
+
+#endif // ASSETS_H
@@ -0,0 +1,20 @@
+#-------------------------------------------------
+#
+# Microbenchmarks for the input hot path
+#
+#-------------------------------------------------
+
+QT += core gui concurrent
+
+TARGET = plabench
+TEMPLATE = app
+
+CONFIG += console c++14 thread
+CONFIG -= app_bundle
+
+include(../engine.pri)
+
+SOURCES += \
+    main.cpp
+
+QMAKE_CXXFLAGS += -Wall -Wextra -pedantic
@@ -0,0 +1,329 @@
+/**
+ * @file main.cpp
+ * @brief Microbenchmarks for the input hot path.
+ *
+ * Usage: plabench [--filter TEXT] [--min-time MS]
+ *
+ * Each benchmark prints one line, "name value ns/op", where value is the
+ * fastest of several timed runs. Keystrokes go to a NullKeyBackend.
+ *
+ * Last, turbo keys are held for a second each at a few rates, printing the
+ * achieved rate ("turbo_30hz_rate ... Hz") and the worst press interval's
+ * distance from the requested period ("turbo_30hz_error_max ... us").
+ */
+#include "bindingmachine.h"
+#include "editing.h"
+#include "gesturerecognizer.h"
+#include "joysticktracker.h"
+#include "keybackend.h"
+#include "macro.h"
+#include "primaryjoysticktracker.h"
+#include "scheduler.h"
+#include "steeringtracker.h"
+
+#include <QCoreApplication>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * Keeps the compiler from optimizing away a computed value.
+ */
+template<typename T>
+static inline void keep(const T& value)
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+static const char *filter = nullptr;
+static std::chrono::milliseconds minTime (200);
+
+/**
+ * Times fn(i) for increasing i, in batches, and prints the best ns/op.
+ */
+static void run(const std::string& name, const std::function<void(unsigned int)>& fn)
+{
+    if (filter != nullptr && name.find(filter) == std::string::npos)
+        return;
+
+    constexpr unsigned int Batch = 4096;
+    constexpr int Runs = 5;
+
+    // Warm up, and bring everything into the cache
+    for (unsigned int i = 0; i < Batch; i++)
+        fn(i);
+
+    double best = 0;
+    for (int r = 0; r < Runs; r++) {
+        unsigned long ops = 0;
+        auto start = Clock::now();
+        auto end = start;
+        do {
+            for (unsigned int i = 0; i < Batch; i++)
+                fn(i);
+            ops += Batch;
+            end = Clock::now();
+        } while (end - start < minTime / Runs);
+
+        double ns = std::chrono::duration<double, std::nano>(end - start).count() / ops;
+        if (r == 0 || ns < best)
+            best = ns;
+    }
+
+    std::cout << name << ' ' << best << " ns/op" << std::endl;
+}
+
+/**
+ * A slow circle that grows and shrinks across both thresholds. It turns 16
+ * times while its radius goes from 0 to 32000 and back, so every direction
+ * is visited past the short and the far threshold, and each sample moves
+ * under 50 axis units.
+ */
+static std::vector<std::pair<int, int>> makeSweep(void)
+{
+    constexpr int Count = 65536;
+    std::vector<std::pair<int, int>> sweep;
+    sweep.reserve(Count);
+
+    for (int i = 0; i < Count; i++) {
+        double angle = 2 * M_PI * i / 4096;
+        double radius = 16000 + 16000 * std::sin(2 * M_PI * i / Count);
+        sweep.emplace_back(static_cast<int>(radius * std::cos(angle)),
+                           static_cast<int>(radius * std::sin(angle)));
+    }
+
+    return sweep;
+}
+
+/**
+ * Notes when each key press reaches the backend.
+ */
+class PressTimes : public KeyBackend
+{
+public:
+    void send(int, Qt::KeyboardModifiers, bool press) override {
+        if (press)
+            times.push_back(Clock::now());
+    }
+
+    std::vector<Clock::time_point> times;
+};
+
+/**
+ * Holds a turbo key for a second on the real Scheduler, and compares the
+ * press rate and intervals with the requested rate.
+ */
+static void measureTurbo(double rate)
+{
+    std::string name = "turbo_" + std::to_string(static_cast<int>(rate)) + "hz";
+    if (filter != nullptr && name.find(filter) == std::string::npos)
+        return;
+
+    PressTimes presses;
+    KeyBackend::setCurrent(&presses);
+
+    KeySender sender (1);
+    sender.setKey(0, Qt::Key_A);
+    sender.setTurbo(0, rate);
+    sender.sendKey(0, true);
+    std::this_thread::sleep_for(std::chrono::seconds(1));
+    sender.sendKey(0, false);
+    KeyBackend::setCurrent(nullptr);
+
+    const auto& t = presses.times;
+    if (t.size() < 2)
+        return;
+
+    double period = 1e6 / rate;
+    double worst = 0;
+    for (size_t i = 1; i < t.size(); i++) {
+        auto interval = std::chrono::duration<double, std::micro>(t[i] - t[i - 1]).count();
+        worst = std::max(worst, std::abs(interval - period));
+    }
+    auto span = std::chrono::duration<double>(t.back() - t.front()).count();
+
+    std::cout << name << "_rate " << (t.size() - 1) / span << " Hz\n"
+              << name << "_error_max " << worst << " us" << std::endl;
+}
+
+static void bindKeys(KeySender& sender, int count)
+{
+    for (int i = 0; i < count; i++)
+        sender.setKey(i, Qt::Key_A + i);
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app (argc, argv);
+
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (hasValue && std::strcmp(argv[i], "--filter") == 0) {
+            filter = argv[++i];
+        } else if (hasValue && std::strcmp(argv[i], "--min-time") == 0) {
+            minTime = std::chrono::milliseconds(std::max(1, std::atoi(argv[++i])));
+        } else {
+            std::cerr << "Usage: " << argv[0]
+                << " [--filter TEXT] [--min-time MS]" << std::endl;
+            return 1;
+        }
+    }
+
+    NullKeyBackend nullBackend;
+    KeyBackend::setCurrent(&nullBackend);
+
+    auto sweep = makeSweep();
+    auto sweepMask = static_cast<unsigned int>(sweep.size() - 1);
+
+    // JoystickTracker::update, for each mode
+    for (int mode = 0; mode < 4; mode++) {
+        bool sequencing = mode & 1;
+        bool diagonals = mode & 2;
+
+        JoystickTracker tracker (sequencing, diagonals);
+        bindKeys(tracker, 17);
+
+        std::string name = "joystick_update";
+        name += sequencing ? "_sequencing" : "_plain";
+        name += diagonals ? "_diagonals" : "";
+        run(name, [&](unsigned int i) {
+            const auto& p = sweep[i & sweepMask];
+            tracker.update(p.first, p.second, (i >> 9) & 1);
+        });
+    }
+
+    {
+        // Flicking between far-apart points, the filter's worst case
+        JoystickTracker tracker;
+        bindKeys(tracker, 17);
+        run("joystick_update_flicks", [&](unsigned int i) {
+            tracker.update(i & 1 ? 30000 : -30000, 0, 0);
+        });
+    }
+
+    // Radial layouts, from the smallest to the largest; the cost should not
+    // grow with the number of sectors
+    for (int sectors : {4, 32}) {
+        SectorLayout layout;
+        layout.addRing({sectors, 0, 6000});
+        if (sectors == 32) {
+            layout.addRing({sectors, 0.1, 16000});
+            layout.addRing({sectors, 0.2, 26000});
+        }
+
+        JoystickTracker tracker;
+        tracker.setLayout(layout);
+        bindKeys(tracker, JoystickTracker::RadialActionBase + layout.actionCount());
+
+        std::string name = "joystick_update_radial_";
+        name += std::to_string(layout.ringCount()) + "x" + std::to_string(sectors);
+        run(name, [&](unsigned int i) {
+            const auto& p = sweep[i & sweepMask];
+            tracker.update(p.first, p.second, (i >> 9) & 1);
+        });
+    }
+
+    {
+        // The sweep sampled at 10 kHz, so its circles are quick enough to
+        // fire; a completing sample should cost no more than any other
+        GestureRecognizer gestures;
+        gestures.setEnabled(true);
+        bindKeys(gestures, GestureRecognizer::GestureCount);
+        run("gestures_update", [&](unsigned int i) {
+            const auto& p = sweep[i & sweepMask];
+            gestures.update(p.first, p.second, static_cast<std::int64_t>(i + 1) * 100000);
+        });
+    }
+
+    {
+        SteeringTracker steering (true);
+        bindKeys(steering, 2);
+        run("steering_update", [&](unsigned int i) {
+            steering.update(static_cast<int>(32000 * std::sin(i * 0.01)));
+        });
+    }
+
+    {
+        // Taps and a chord on the stick buttons; no holds or double taps,
+        // which would leave a Scheduler task per press while it is stopped
+        BindingMachine bindings;
+        for (int button = 0; button < 3; button++)
+            bindings.setKey(BindingMachine::slotOf(button, BindingMachine::Tap),
+                Qt::Key_A + button);
+        bindings.setChord(0, 1, 3);
+        bindings.setKey(BindingMachine::chordSlot(0), Qt::Key_Z);
+        bindings.compile();
+        run("bindings_update", [&](unsigned int i) {
+            keep(bindings.update(i & 0xF, i));
+        });
+    }
+
+    {
+        KeySender sender (17);
+        bindKeys(sender, 17);
+        run("keysender_sendkey", [&](unsigned int i) {
+            sender.sendKey(static_cast<int>((i >> 1) % 17), !(i & 1));
+        });
+    }
+
+    {
+        std::string text;
+        static const Qt::KeyboardModifiers mods[] = {
+            Qt::NoModifier, Qt::ShiftModifier, Qt::ControlModifier,
+            Qt::ControlModifier | Qt::AltModifier | Qt::ShiftModifier
+        };
+        static const int keys[] = {
+            Qt::Key_A, Qt::Key_Z, Qt::Key_5, Qt::Key_Space, Qt::Key_Up,
+            Qt::Key_F5, Qt::Key_Shift, Qt::Key_Return
+        };
+        run("key_sequence", [&](unsigned int i) {
+            NativeKeyBackend::keySequence(keys[i & 7], mods[(i >> 3) & 3], text);
+            keep(text.data());
+        });
+    }
+
+    {
+        std::vector<std::string> names;
+        for (int i = 0; i < 64; i++) {
+            names.push_back("Macro " + std::to_string(i));
+            Macro::get(names.back());
+        }
+        names.push_back("Missing");
+
+        run("macro_exists", [&](unsigned int i) {
+            bool found = Macro::exists(names[i % names.size()]);
+            keep(found);
+        });
+    }
+
+    {
+        PrimaryJoystickTracker primary;
+        for (int pg = 0; pg < 8; pg++)
+            bindKeys(primary.getPG(pg), 17);
+
+        Editing<PrimaryJoystickTracker> editing (primary);
+        run("editing_primary_ismodified", [&](unsigned int) {
+            bool modified = editing.isModified();
+            keep(modified);
+        });
+    }
+
+    KeyBackend::setCurrent(nullptr);
+
+    Scheduler::start();
+    for (double rate : {5., 30., 60.})
+        measureTurbo(rate);
+    Scheduler::stop();
+
+    return 0;
+}
@@ -0,0 +1,92 @@
+#include "clientwindow.h"
+
+#include "profile.h"
+
+#include <QMessageBox>
+
+ClientWindow::ClientWindow(QWidget *parent) :
+    QWidget(parent),
+    client(this),
+    status(this),
+    profiles(this),
+    pgs(this),
+    enabled("Fire actions", this)
+{
+    setWindowTitle("PLA ALT");
+    setFixedSize(320, 130);
+
+    status.setGeometry(10, 10, 300, 40);
+    status.setWordWrap(true);
+    profiles.setGeometry(10, 60, 190, 24);
+    pgs.setGeometry(210, 60, 100, 24);
+    enabled.setGeometry(10, 96, 200, 20);
+
+    profiles.addItems(Profile::list());
+    for (int i = 1; i <= 8; i++)
+        pgs.addItem("PG " + QString::number(i));
+    setControlsEnabled(false);
+
+    connect(&client, SIGNAL(stateChanged(bool, bool, int, QString)),
+        this, SLOT(showState(bool, bool, int, QString)));
+    connect(&client, SIGNAL(commandFailed(QString)), this, SLOT(showError(QString)));
+    connect(&client, SIGNAL(closed()), this, SLOT(showClosed()));
+
+    connect(&profiles, SIGNAL(activated(QString)), this, SLOT(selectProfile(QString)));
+    connect(&pgs, SIGNAL(activated(int)), this, SLOT(selectPG(int)));
+    connect(&enabled, SIGNAL(clicked(bool)), this, SLOT(enableActions(bool)));
+}
+
+bool ClientWindow::attach(void)
+{
+    status.setText("Connecting to PLA_ALTd...");
+    return client.open();
+}
+
+void ClientWindow::showState(bool connected, bool enable, int pg, const QString& profile)
+{
+    setControlsEnabled(true);
+    status.setText(connected ?
+        "PLA_ALTd is running. The controller is connected." :
+        "PLA_ALTd is running. Waiting for the controller to be connected.");
+
+    // The daemon may have opened a profile created after this window
+    if (profiles.findText(profile) < 0)
+        profiles.addItem(profile);
+    profiles.setCurrentText(profile);
+    pgs.setCurrentIndex(pg);
+    enabled.setChecked(enable);
+}
+
+void ClientWindow::showError(const QString& reply)
+{
+    QMessageBox::warning(this, "PLA ALT", "PLA_ALTd refused the change (" +
+        reply.mid(6) + ").", QMessageBox::Ok);
+}
+
+void ClientWindow::showClosed(void)
+{
+    status.setText("PLA_ALTd has stopped. Start PLA ALT again to use the controller.");
+    setControlsEnabled(false);
+}
+
+void ClientWindow::setControlsEnabled(bool enable)
+{
+    profiles.setEnabled(enable);
+    pgs.setEnabled(enable);
+    enabled.setEnabled(enable);
+}
+
+void ClientWindow::selectProfile(const QString& name)
+{
+    client.send("profile " + name);
+}
+
+void ClientWindow::selectPG(int index)
+{
+    client.send("pg " + QString::number(index));
+}
+
+void ClientWindow::enableActions(bool enable)
+{
+    client.send(enable ? "enable" : "disable");
+}
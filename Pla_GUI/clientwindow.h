@@ -0,0 +1,56 @@
+/**
+ * @file clientwindow.h
+ * @brief Window for controlling PLA_ALTd from the desktop.
+ */
+#ifndef CLIENTWINDOW_H
+#define CLIENTWINDOW_H
+
+#include "controlclient.h"
+
+#include <QCheckBox>
+#include <QComboBox>
+#include <QLabel>
+#include <QWidget>
+
+/**
+ * @class ClientWindow
+ * @brief Shown by PLA_ALT when PLA_ALTd is already driving the controller.
+ *
+ * Attaches to the daemon through its control socket, showing whether the
+ * controller is connected and letting the profile, PG and enabled state be
+ * changed. Profiles are edited by PLA_ALT alone, so the editing tabs aren't
+ * available here.
+ */
+class ClientWindow : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit ClientWindow(QWidget *parent = nullptr);
+
+    /**
+     * Connects to the daemon.
+     * @return True if success
+     */
+    bool attach(void);
+
+private slots:
+    void showState(bool connected, bool enabled, int pg, const QString& profile);
+    void showError(const QString& reply);
+    void showClosed(void);
+
+    void selectProfile(const QString& name);
+    void selectPG(int index);
+    void enableActions(bool enable);
+
+private:
+    ControlClient client;
+    QLabel status;
+    QComboBox profiles;
+    QComboBox pgs;
+    QCheckBox enabled;
+
+    void setControlsEnabled(bool enable);
+};
+
+#endif // CLIENTWINDOW_H
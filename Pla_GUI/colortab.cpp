@@ -1,4 +1,5 @@
 #include "colortab.h"
+#include "assets.h"
 #include "controller.h"
 #include "profile.h"
 #include "serial.h"
@@ -17,9 +18,9 @@ ColorTab::ColorTab(QWidget *parent) :
     ledOff(this),
     updateTimer(this)
 {
-    ledOn.setIcon(QIcon("assets/color-on.png"));
+    ledOn.setIcon(Assets::icon("color-on.png"));
     ledOn.setIconSize(QSize(75, 79));
-    ledOff.setIcon(QIcon("assets/color-off.png"));
+    ledOff.setIcon(Assets::icon("color-off.png"));
     ledOff.setIconSize(QSize(75, 79));
 
     // Set control positions
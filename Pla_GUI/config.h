@@ -26,6 +26,18 @@ namespace config
      * Controls delay between controller input polling.
      */
     constexpr auto InputUpdateFrequency = 10ms;
+    /**
+     * Highest polling rate that may be requested (--poll-rate), in Hz.
+     */
+    constexpr unsigned int MaxPollRate = 1000;
+    /**
+     * SCHED_FIFO priority requested for the controller thread by --realtime.
+     */
+    constexpr int RealtimePriority = 10;
+    /**
+     * Nice value tried when real-time scheduling is refused.
+     */
+    constexpr int HighPriorityNice = -10;
     /**
      * Delay after sending each key event.
      * This may not be necessary; it's just to be safe.
@@ -35,6 +47,20 @@ namespace config
      * Delay between checking for a connected joystick.
      */
     constexpr auto ConnectionCheckFrequency = 1s;
+    /**
+     * How long to wait for the controller at startup before warning that it
+     * is not connected.
+     */
+    constexpr std::chrono::milliseconds ConnectionWaitTimeout = 2s;
+    /**
+     * Longest time to wait for a reply from the controller over serial.
+     */
+    constexpr auto SerialReadTimeout = 500ms;
+    /**
+     * Longest time a second launch waits on the running instance's control
+     * socket.
+     */
+    constexpr std::chrono::milliseconds ControlTimeout = 1s;
 
     /**
      * Minimum delay between macro key presses/releases.
@@ -57,12 +83,31 @@ namespace config
     };
 
     /**
-     * Defines the minimum rate-of-change in a joystick to be considered movement.
-     * Actions will not be fired unless the joystick is moving at a lesser speed.
+     * Default one-euro filter settings for the sticks (see InputConditioning).
+     * The cutoff is StickFilterMinCutoff Hz at rest and rises by
+     * StickFilterBeta Hz per axis unit/second of speed, so a fast flick
+     * (~500000 units/s) is barely delayed.
      *
      * Note: Axes in SDL have a range of -32767 to +32767
      */
-    constexpr double JoystickSpeedThreshold = 100;
+    constexpr double StickFilterMinCutoff = 5.0;
+    constexpr double StickFilterBeta = 0.0002;
+    /**
+     * Cutoff, in Hz, for the speed estimate the one-euro filter adapts to.
+     */
+    constexpr double StickFilterDerivativeCutoff = 1.0;
+    /**
+     * Longest gap between samples, in seconds, that the filter smooths
+     * across; after a longer gap it restarts at the new position.
+     */
+    constexpr double StickFilterMaxGap = 0.1;
+
+    /**
+     * Default hysteresis: how far past a threshold ring (in axis units) or a
+     * direction boundary (in radians) a stick must go to cross it.
+     */
+    constexpr int StickRadialHysteresis = 1000;
+    constexpr double StickAngleHysteresis = 0.05;
 
     /**
      * Default threshold value for vector 1 / normal actions.
@@ -74,6 +119,81 @@ namespace config
      */
     constexpr int JoystickDefaultFarThreshold = static_cast<int>(32767 * 0.9f);
 
+    /**
+     * Default virtual gamepad deadzone, in axis units.
+     */
+    constexpr int GamepadDeadzone = static_cast<int>(32767 * 0.1f);
+
+    /**
+     * Ticks per second for sticks moving the pointer, and how often to check
+     * for a stick entering pointer mode while none is.
+     */
+    constexpr unsigned int PointerRate = 500;
+    constexpr std::chrono::milliseconds PointerIdleCheck = 100ms;
+    /**
+     * Default pointer settings: full-deflection speeds (pixels and scroll
+     * steps per second), deadzone (axis units) and acceleration exponent.
+     */
+    constexpr double PointerSpeed = 1500;
+    constexpr double ScrollSpeed = 20;
+    constexpr int PointerDeadzone = static_cast<int>(32767 * 0.1f);
+    constexpr double PointerAcceleration = 2;
+
+    /**
+     * Default period and response curve for proportional steering.
+     */
+    constexpr std::chrono::milliseconds SteeringPulsePeriod = 50ms;
+    constexpr double SteeringPulseCurve = 1.0;
+    /**
+     * Shortest press or gap that proportional steering and turbo keys will
+     * produce; anything shorter may be missed by the game.
+     */
+    constexpr std::chrono::milliseconds MinimumKeyPulse = 2ms;
+    /**
+     * Range of proportional steering's pulse period. A period needs room
+     * for both a press and a gap.
+     */
+    constexpr std::chrono::milliseconds SteeringMinPulsePeriod = 2 * MinimumKeyPulse;
+    constexpr std::chrono::milliseconds SteeringMaxPulsePeriod = 1000ms;
+
+    /**
+     * Range of turbo rates, in presses per second.
+     */
+    constexpr double TurboMinRate = 1;
+    constexpr double TurboMaxRate = 60;
+
+    /**
+     * Default time a bound button must be down to count as a hold, and the
+     * longest gap between the taps of a double tap.
+     */
+    constexpr std::chrono::milliseconds HoldTime = 300ms;
+    constexpr std::chrono::milliseconds DoubleTapTime = 250ms;
+
+    /**
+     * Default gesture settings: how far out (in axis units) a stick's angle
+     * is followed, and the longest time a circle, quarter-circle and flick
+     * may take. Inside the center radius a motion ends.
+     */
+    constexpr int GestureRadius = static_cast<int>(32767 * 0.7f);
+    constexpr int GestureCenter = static_cast<int>(32767 * 0.25f);
+    constexpr std::chrono::milliseconds GestureCircleTime = 500ms;
+    constexpr std::chrono::milliseconds GestureQuarterTime = 200ms;
+    constexpr std::chrono::milliseconds GestureFlickTime = 150ms;
+
+    /**
+     * Most memory, in kilobytes, to spend on decoded asset images.
+     */
+    constexpr int AssetCacheLimit = 8192;
+
+    /**
+     * Number of trace events each thread keeps; older events are overwritten.
+     */
+    constexpr unsigned int TraceEventsPerThread = 16384;
+    /**
+     * Number of exited threads whose trace events are kept.
+     */
+    constexpr unsigned int TraceRetiredThreads = 8;
+
     /**
      * Time to show tray messages, in milliseconds.
      */
@@ -0,0 +1,61 @@
+#include "controlclient.h"
+
+#include "config.h"
+#include "controlserver.h"
+
+ControlClient::ControlClient(QObject *parent) :
+    QObject(parent),
+    socket(this)
+{
+    connect(&socket, SIGNAL(readyRead()), this, SLOT(readLines()));
+    connect(&socket, SIGNAL(disconnected()), this, SIGNAL(closed()));
+}
+
+bool ControlClient::open(void)
+{
+    socket.connectToServer(ControlServer::socketName());
+    if (!socket.waitForConnected(config::ControlTimeout.count()))
+        return false;
+
+    send("subscribe");
+    return true;
+}
+
+void ControlClient::send(const QString& command)
+{
+    socket.write(command.toUtf8() + '\n');
+    socket.flush();
+}
+
+void ControlClient::readLines(void)
+{
+    while (socket.canReadLine()) {
+        auto line = QString::fromUtf8(socket.readLine()).trimmed();
+        if (line.startsWith("error")) {
+            emit commandFailed(line);
+            continue;
+        }
+        if (!line.startsWith("state "))
+            continue;
+
+        // "state connected=C enabled=E pg=N profile=NAME"; the name may
+        // contain spaces, so it is taken whole
+        auto profileAt = line.indexOf(" profile=");
+        if (profileAt < 0)
+            continue;
+
+        bool connected = false;
+        bool enabled = false;
+        int pg = 0;
+        for (const auto& field : line.left(profileAt).split(' ')) {
+            if (field.startsWith("connected="))
+                connected = field.mid(10) == "1";
+            else if (field.startsWith("enabled="))
+                enabled = field.mid(8) == "1";
+            else if (field.startsWith("pg="))
+                pg = field.mid(3).toInt();
+        }
+
+        emit stateChanged(connected, enabled, pg, line.mid(profileAt + 9));
+    }
+}
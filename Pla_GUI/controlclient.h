@@ -0,0 +1,56 @@
+/**
+ * @file controlclient.h
+ * @brief Stays connected to a running instance's control socket.
+ */
+#ifndef CONTROLCLIENT_H
+#define CONTROLCLIENT_H
+
+#include <QLocalSocket>
+#include <QObject>
+#include <QString>
+
+/**
+ * @class ControlClient
+ * @brief Subscribes to the state of a running instance (see ControlServer)
+ * and sends it commands, without waiting for the replies.
+ */
+class ControlClient : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ControlClient(QObject *parent = nullptr);
+
+    /**
+     * Connects to the running instance and subscribes to its state.
+     * @return True if success
+     */
+    bool open(void);
+
+    /**
+     * Sends a command line, without its line ending. An error reply is
+     * reported through commandFailed().
+     */
+    void send(const QString& command);
+
+signals:
+    /**
+     * Emitted for every state line, starting with the one sent on subscribing.
+     */
+    void stateChanged(bool connected, bool enabled, int pg, const QString& profile);
+
+    void commandFailed(const QString& reply);
+
+    /**
+     * Emitted when the running instance goes away.
+     */
+    void closed(void);
+
+private slots:
+    void readLines(void);
+
+private:
+    QLocalSocket socket;
+};
+
+#endif // CONTROLCLIENT_H
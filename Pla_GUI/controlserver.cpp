@@ -0,0 +1,185 @@
+#include "controlserver.h"
+
+#include "config.h"
+#include "controller.h"
+#include "eventbus.h"
+#include "profile.h"
+#include "serial.h"
+#include "trace.h"
+
+#include <QMetaMethod>
+#include <QStandardPaths>
+
+#include <algorithm>
+
+ControlServer::ControlServer(QObject *parent) :
+    QObject(parent)
+{
+    server.setSocketOptions(QLocalServer::UserAccessOption);
+    connect(&server, SIGNAL(newConnection()), this, SLOT(acceptClients()));
+
+    auto bus = EventBus::instance();
+    connect(bus, SIGNAL(connectionChanged(bool)), this, SLOT(checkState()));
+    connect(bus, SIGNAL(pgChanged(int)), this, SLOT(checkState()));
+    connect(bus, SIGNAL(profileChanged()), this, SLOT(checkState()));
+}
+
+ControlServer::~ControlServer(void)
+{
+    server.close();
+}
+
+QString ControlServer::socketName(void)
+{
+#ifdef PLA_WINDOWS
+    return "pla_alt_control";
+#else
+    auto dir = QStandardPaths::writableLocation(QStandardPaths::RuntimeLocation);
+    if (dir.isEmpty())
+        dir = QStandardPaths::writableLocation(QStandardPaths::TempLocation);
+    return dir + "/pla_alt.sock";
+#endif
+}
+
+bool ControlServer::listen(void)
+{
+    QLocalServer::removeServer(socketName());
+    return server.listen(socketName());
+}
+
+bool ControlServer::send(const QStringList& commands, QStringList *replies)
+{
+    QLocalSocket socket;
+    socket.connectToServer(socketName());
+    if (!socket.waitForConnected(config::ControlTimeout.count()))
+        return false;
+
+    for (const auto& command : commands)
+        socket.write(command.toUtf8() + '\n');
+    if (!socket.waitForBytesWritten(config::ControlTimeout.count()))
+        return false;
+
+    bool success = true;
+    for (int i = 0; i < commands.size(); i++) {
+        while (!socket.canReadLine()) {
+            if (!socket.waitForReadyRead(config::ControlTimeout.count()))
+                return false;
+        }
+
+        auto reply = QString::fromUtf8(socket.readLine()).trimmed();
+        if (reply.startsWith("error"))
+            success = false;
+        if (replies != nullptr)
+            replies->append(reply);
+    }
+
+    return success;
+}
+
+void ControlServer::acceptClients(void)
+{
+    while (auto client = server.nextPendingConnection()) {
+        connect(client, SIGNAL(readyRead()), this, SLOT(readCommands()));
+        connect(client, SIGNAL(disconnected()), this, SLOT(removeClient()));
+    }
+}
+
+void ControlServer::readCommands(void)
+{
+    auto client = qobject_cast<QLocalSocket *>(sender());
+    if (client == nullptr)
+        return;
+
+    while (client->canReadLine()) {
+        auto command = QString::fromUtf8(client->readLine()).trimmed();
+        if (!command.isEmpty())
+            client->write(handle(client, command).toUtf8() + '\n');
+    }
+
+    // Answer now rather than on the next event loop pass
+    client->flush();
+
+    // Catch changes that don't come through the event bus (enable/disable)
+    checkState();
+}
+
+void ControlServer::removeClient(void)
+{
+    auto client = qobject_cast<QLocalSocket *>(sender());
+    if (client == nullptr)
+        return;
+
+    subscribers.erase(std::remove(subscribers.begin(), subscribers.end(), client),
+        subscribers.end());
+    client->deleteLater();
+}
+
+void ControlServer::checkState(void)
+{
+    if (subscribers.empty())
+        return;
+
+    auto state = stateLine();
+    if (state == lastState)
+        return;
+
+    lastState = state;
+    auto line = state.toUtf8() + '\n';
+    for (auto client : subscribers) {
+        client->write(line);
+        client->flush();
+    }
+}
+
+QString ControlServer::handle(QLocalSocket *client, const QString& command)
+{
+    PLA_TRACE_SCOPE("control", "ControlServer::handle");
+
+    auto space = command.indexOf(' ');
+    auto name = command.left(space);
+    auto arg = space < 0 ? QString() : command.mid(space + 1).trimmed();
+
+    if (name == "profile") {
+        if (arg.isEmpty())
+            return "error missing profile name";
+        // Profile::open() would create a missing profile and switch to it
+        if (!Profile::list().contains(arg))
+            return "error unknown profile";
+        if (arg != Profile::name())
+            Profile::open(arg);
+    } else if (name == "pg") {
+        bool ok = false;
+        auto pg = arg.toUInt(&ok);
+        if (!ok || pg > 7)
+            return "error pg must be 0-7";
+        Controller::selectPG(pg);
+        if (Serial::connected())
+            Serial::setPg(pg);
+    } else if (name == "enable" || name == "disable") {
+        Controller::setSuspended(name == "disable");
+    } else if (name == "show") {
+        if (!isSignalConnected(QMetaMethod::fromSignal(&ControlServer::showRequested)))
+            return "error no window to show";
+        emit showRequested();
+    } else if (name == "state") {
+        return stateLine();
+    } else if (name == "subscribe") {
+        if (std::find(subscribers.begin(), subscribers.end(), client) == subscribers.end())
+            subscribers.push_back(client);
+        lastState = stateLine();
+        return lastState;
+    } else {
+        return "error unknown command";
+    }
+
+    return "ok";
+}
+
+QString ControlServer::stateLine(void)
+{
+    return QString("state connected=%1 enabled=%2 pg=%3 profile=%4")
+        .arg(Controller::connected() ? 1 : 0)
+        .arg(Controller::isSuspended() ? 0 : 1)
+        .arg(Controller::getPG())
+        .arg(Profile::name());
+}
@@ -0,0 +1,97 @@
+/**
+ * @file controlserver.h
+ * @brief Local control API for the running instance.
+ */
+#ifndef CONTROLSERVER_H
+#define CONTROLSERVER_H
+
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+
+#include <vector>
+
+/**
+ * @class ControlServer
+ * @brief Lets other programs (and second launches of PLA ALT) control the
+ * running instance through a local socket.
+ *
+ * On Linux this is a Unix-domain socket at $XDG_RUNTIME_DIR/pla_alt.sock;
+ * on Windows it is a named pipe. The protocol is line based, UTF-8, with one
+ * reply line per command:
+ *
+ *     profile NAME   Opens a profile              -> ok | error MESSAGE
+ *     pg N           Selects PG N (0-7)           -> ok | error MESSAGE
+ *     enable         Resumes firing actions       -> ok
+ *     disable        Stops firing actions         -> ok
+ *     show           Shows the main window        -> ok | error MESSAGE
+ *     state          Gets the current state       -> state ...
+ *     subscribe      Sends a state line now and after every change
+ *
+ * A state line is "state connected=C enabled=E pg=N profile=NAME"; the
+ * profile name is last since it may contain spaces.
+ *
+ * Commands are handled on the thread that owns the server, as soon as they
+ * arrive, so it should be the (normally idle) main thread.
+ */
+class ControlServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ControlServer(QObject *parent = nullptr);
+    ~ControlServer(void);
+
+    /**
+     * Starts listening, replacing any socket left by a crashed instance.
+     * Only call this while holding the run guard.
+     * @return True if success
+     */
+    bool listen(void);
+
+    /**
+     * Sends commands to the running instance.
+     * @param commands The command lines, without line endings
+     * @param replies If not null, receives one reply per command
+     * @return True if every command was answered with something other than
+     * an error
+     */
+    static bool send(const QStringList& commands, QStringList *replies = nullptr);
+
+    /**
+     * Gets the name of the socket (its path on Linux).
+     */
+    static QString socketName(void);
+
+signals:
+    /**
+     * Emitted for the "show" command. If nothing is connected, "show" is
+     * answered with an error.
+     */
+    void showRequested(void);
+
+private slots:
+    void acceptClients(void);
+    void readCommands(void);
+    void removeClient(void);
+    void checkState(void);
+
+private:
+    QLocalServer server;
+    std::vector<QLocalSocket *> subscribers;
+    QString lastState;
+
+    /**
+     * Runs one command.
+     * @param client The client that sent it, for subscriptions
+     * @param command The command line
+     * @return The reply line
+     */
+    QString handle(QLocalSocket *client, const QString& command);
+
+    static QString stateLine(void);
+};
+
+#endif // CONTROLSERVER_H
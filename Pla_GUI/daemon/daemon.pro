@@ -0,0 +1,34 @@
+#-------------------------------------------------
+#
+# PLA ALT without a user interface
+#
+#-------------------------------------------------
+
+QT += core gui concurrent
+QT -= widgets
+qtHaveModule(dbus) {
+    QT += dbus
+    DEFINES += PLA_DBUS
+}
+
+TARGET = PLA_ALTd
+TEMPLATE = app
+
+CONFIG += console c++14 thread
+CONFIG -= app_bundle
+
+DEFINES += QT_DEPRECATED_WARNINGS
+win32: DEFINES += PLA_WINDOWS
+
+include(../engine.pri)
+
+SOURCES += \
+    desktopnotifier.cpp \
+    main.cpp
+
+HEADERS += \
+    desktopnotifier.h
+
+unix:!macx: QMAKE_CXXFLAGS += -Wall -Wextra -pedantic
+win32: LIBS += -L.. -lSDL2 -lSDL2main -luser32 -lSetupAPI
+win32: QMAKE_CXXFLAGS += /std:c++latest
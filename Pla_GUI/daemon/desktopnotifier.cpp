@@ -0,0 +1,25 @@
+#include "desktopnotifier.h"
+
+#ifdef PLA_DBUS
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QStringList>
+#include <QVariantMap>
+#endif
+
+#include <iostream>
+
+void DesktopNotifier::show(const QString& title, const QString& message)
+{
+    std::cout << title.toStdString() << ": " << message.toStdString() << std::endl;
+
+#ifdef PLA_DBUS
+    auto call = QDBusMessage::createMethodCall("org.freedesktop.Notifications",
+        "/org/freedesktop/Notifications", "org.freedesktop.Notifications", "Notify");
+    call << QString("PLA ALT") << quint32(0) << QString() << title << message
+         << QStringList() << QVariantMap() << qint32(4000);
+
+    // Fire and forget; there may be no notification service at all
+    QDBusConnection::sessionBus().call(call, QDBus::NoBlock);
+#endif
+}
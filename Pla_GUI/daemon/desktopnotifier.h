@@ -0,0 +1,25 @@
+/**
+ * @file desktopnotifier.h
+ * @brief Notifications for when there is no tray icon.
+ */
+#ifndef DESKTOPNOTIFIER_H
+#define DESKTOPNOTIFIER_H
+
+#include <QString>
+
+/**
+ * @class DesktopNotifier
+ * @brief Shows messages through the desktop's notification service, where
+ * there is one (freedesktop.org notifications over D-Bus), and always logs
+ * them to standard output.
+ */
+class DesktopNotifier
+{
+public:
+    /**
+     * Shows a message. Safe to call from any thread; never blocks.
+     */
+    static void show(const QString& title, const QString& message);
+};
+
+#endif // DESKTOPNOTIFIER_H
@@ -0,0 +1,139 @@
+/**
+ * @file main.cpp
+ * @brief PLA ALT's input engine, without a user interface.
+ *
+ * Usage: PLA_ALTd [--profile NAME] [engine options]
+ *
+ * Loads a profile (the first one, unless --profile is given) and drives the
+ * controller until interrupted. Connection changes are shown as desktop
+ * notifications. Only one of PLA_ALT and PLA_ALTd drives the controller at
+ * a time; PLA_ALT started while PLA_ALTd runs attaches to it instead (see
+ * ClientWindow).
+ */
+#include "config.h"
+#include "controller.h"
+#include "controlserver.h"
+#include "desktopnotifier.h"
+#include "engine.h"
+#include "eventbus.h"
+#include "profile.h"
+
+#include <QCoreApplication>
+#include <QSharedMemory>
+
+#include <chrono>
+#include <csignal>
+#include <iostream>
+
+#ifndef PLA_WINDOWS
+#include <QSocketNotifier>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+// See the note in the GUI's main.cpp
+#ifdef PLA_WINDOWS
+#undef main
+#endif
+
+#ifndef PLA_WINDOWS
+static int signalPipe[2] = {-1, -1};
+#endif
+
+/**
+ * Quits the event loop on SIGINT/SIGTERM. Signal handlers may not touch Qt,
+ * so on POSIX systems the handler only wakes the event loop through a pipe.
+ */
+static void handleQuitSignals(QCoreApplication& app)
+{
+#ifdef PLA_WINDOWS
+    (void)app;
+    auto quit = [](int) { QCoreApplication::quit(); };
+    std::signal(SIGINT, quit);
+    std::signal(SIGTERM, quit);
+#else
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, signalPipe) != 0)
+        return;
+
+    auto notifier = new QSocketNotifier(signalPipe[1], QSocketNotifier::Read, &app);
+    QObject::connect(notifier, &QSocketNotifier::activated, &app, [] {
+        char c;
+        auto r = ::read(signalPipe[1], &c, 1);
+        (void)r;
+        QCoreApplication::quit();
+    });
+
+    auto wake = [](int) {
+        char c = 1;
+        auto w = ::write(signalPipe[0], &c, 1);
+        (void)w;
+    };
+    std::signal(SIGINT, wake);
+    std::signal(SIGTERM, wake);
+#endif
+}
+
+int main(int argc, char *argv[])
+{
+    auto startTime = std::chrono::steady_clock::now();
+    auto logPhase = [&startTime](const char *phase) {
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - startTime);
+        std::cout << "Startup: " << phase << " at " << elapsed.count() << "ms, "
+                  << Engine::residentMemory() << "kB resident" << std::endl;
+    };
+
+    QCoreApplication app (argc, argv);
+    app.setApplicationName("PLA ALT");
+
+    QCommandLineParser args;
+    args.addHelpOption();
+    Engine::addOptions(args);
+    args.process(app);
+    if (!Engine::checkOptions(args))
+        return 1;
+
+    QSharedMemory runGuard (Engine::RunGuardKey);
+    if (!runGuard.create(1)) {
+        // Pass on anything the running instance can act on
+        auto commands = Engine::forwardedCommands(args);
+        if (!commands.isEmpty() && ControlServer::send(commands))
+            return 0;
+
+        std::cerr << "PLA ALT is already running." << std::endl;
+        return 1;
+    }
+
+    handleQuitSignals(app);
+    logPhase("application ready");
+
+    if (args.isSet("profile"))
+        Profile::open(args.value("profile"));
+    else
+        Profile::openFirst();
+    logPhase("profile loaded");
+
+    auto bus = EventBus::instance();
+    QObject::connect(bus, &EventBus::connectionChanged, [](bool connected) {
+        DesktopNotifier::show("PLA", connected ? "Controller connected!" :
+            "Controller disconnected.");
+    });
+    QObject::connect(bus, &EventBus::error, [](const QString& message) {
+        DesktopNotifier::show("PLA ALT", message);
+    });
+
+    if (!Engine::start(args)) {
+        std::cerr << "Unable to start SDL." << std::endl;
+        return 1;
+    }
+    logPhase("controller init");
+
+    if (!Controller::waitForConnection(config::ConnectionWaitTimeout)) {
+        DesktopNotifier::show("Controller Disconnected",
+            "Unable to find the PLA ALT controller. Waiting for it to be connected.");
+    }
+
+    auto ret = app.exec();
+    Engine::stop();
+    return ret;
+}
@@ -0,0 +1,113 @@
+#include "diagnosticsdialog.h"
+
+#include "latency.h"
+#include "trace.h"
+
+#include <QFileDialog>
+#include <QFontDatabase>
+#include <QMessageBox>
+
+#include <fstream>
+#include <sstream>
+
+DiagnosticsDialog::DiagnosticsDialog(QWidget *parent) :
+    QDialog(parent),
+    collect("Collect timings", this),
+    report(this),
+    resetButton("RESET", this),
+    saveButton("SAVE...", this),
+    trace("Record trace", this),
+    saveTraceButton("SAVE TRACE...", this),
+    refreshTimer(this)
+{
+    setWindowTitle("Diagnostics");
+    setFixedSize(420, 220);
+
+    collect.setGeometry(10, 10, 200, 20);
+    report.setGeometry(10, 40, 400, 140);
+    resetButton.setGeometry(270, 190, 60, 20);
+    saveButton.setGeometry(340, 190, 70, 20);
+    trace.setGeometry(10, 190, 110, 20);
+    saveTraceButton.setGeometry(130, 190, 100, 20);
+
+    report.setReadOnly(true);
+    report.setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+
+    connect(&collect, SIGNAL(toggled(bool)), this, SLOT(setCollecting(bool)));
+    connect(&resetButton, SIGNAL(released()), this, SLOT(reset()));
+    connect(&saveButton, SIGNAL(released()), this, SLOT(saveToFile()));
+    connect(&trace, SIGNAL(toggled(bool)), this, SLOT(setTracing(bool)));
+    connect(&saveTraceButton, SIGNAL(released()), this, SLOT(saveTrace()));
+    connect(&refreshTimer, SIGNAL(timeout()), this, SLOT(refresh()));
+}
+
+void DiagnosticsDialog::showEvent(QShowEvent *event)
+{
+    collect.setChecked(Latency::isEnabled());
+    trace.setChecked(Trace::isEnabled());
+    refresh();
+    refreshTimer.start(500);
+    QDialog::showEvent(event);
+}
+
+void DiagnosticsDialog::hideEvent(QHideEvent *event)
+{
+    refreshTimer.stop();
+    QDialog::hideEvent(event);
+}
+
+void DiagnosticsDialog::refresh(void)
+{
+    std::ostringstream text;
+    Latency::dump(text);
+    report.setPlainText(QString::fromStdString(text.str()));
+}
+
+void DiagnosticsDialog::setCollecting(bool enable)
+{
+    Latency::setEnabled(enable);
+}
+
+void DiagnosticsDialog::reset(void)
+{
+    Latency::reset();
+    refresh();
+}
+
+void DiagnosticsDialog::saveToFile(void)
+{
+    auto path = QFileDialog::getSaveFileName(this, "Save Timings",
+        "latency.txt", "Text files (*.txt)");
+    if (path.isEmpty())
+        return;
+
+    std::ofstream file (path.toStdString());
+    if (!file.is_open()) {
+        QMessageBox::warning(this, "Diagnostics", "Unable to write the file.",
+            QMessageBox::Ok);
+        return;
+    }
+
+    Latency::dump(file);
+}
+
+void DiagnosticsDialog::setTracing(bool enable)
+{
+    // Start each recording fresh
+    if (enable && !Trace::isEnabled())
+        Trace::clear();
+    Trace::setEnabled(enable);
+}
+
+void DiagnosticsDialog::saveTrace(void)
+{
+    auto path = QFileDialog::getSaveFileName(this, "Save Trace",
+        "trace.json", "Trace files (*.json)");
+    if (path.isEmpty())
+        return;
+
+    if (!Trace::write(path.toStdString().c_str())) {
+        QMessageBox::warning(this, "Diagnostics", "Unable to write the file.",
+            QMessageBox::Ok);
+    }
+}
@@ -0,0 +1,49 @@
+/**
+ * @file diagnosticsdialog.h
+ * @brief Dialog for viewing input latency measurements and saving traces.
+ */
+#ifndef DIAGNOSTICSDIALOG_H
+#define DIAGNOSTICSDIALOG_H
+
+#include <QCheckBox>
+#include <QDialog>
+#include <QHideEvent>
+#include <QPlainTextEdit>
+#include <QPushButton>
+#include <QShowEvent>
+#include <QTimer>
+
+/**
+ * @class DiagnosticsDialog
+ * @brief Shows the Latency histograms, refreshing while visible, and
+ * controls Trace recording.
+ */
+class DiagnosticsDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit DiagnosticsDialog(QWidget *parent = nullptr);
+
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
+
+private slots:
+    void refresh(void);
+    void setCollecting(bool enable);
+    void reset(void);
+    void saveToFile(void);
+    void setTracing(bool enable);
+    void saveTrace(void);
+
+private:
+    QCheckBox collect;
+    QPlainTextEdit report;
+    QPushButton resetButton;
+    QPushButton saveButton;
+    QCheckBox trace;
+    QPushButton saveTraceButton;
+    QTimer refreshTimer;
+};
+
+#endif // DIAGNOSTICSDIALOG_H
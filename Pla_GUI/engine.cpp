@@ -0,0 +1,186 @@
+#include "engine.h"
+
+#include "capture.h"
+#include "controller.h"
+#include "eventbus.h"
+#include "latency.h"
+#include "pointerengine.h"
+#include "scheduler.h"
+#include "stateexport.h"
+#include "trace.h"
+
+#include <QFile>
+
+#include <fstream>
+#include <iostream>
+
+#ifndef PLA_WINDOWS
+#include <unistd.h>
+#endif
+
+QString Engine::latencyLogPath;
+QString Engine::tracePath;
+ControlServer *Engine::control = nullptr;
+
+static CaptureWriter capture;
+#ifdef PLA_UINPUT
+static VirtualGamepad gamepad;
+#endif
+
+/**
+ * Logs a start-up problem and passes it on to the user interface.
+ * @param message A string literal describing the problem
+ */
+static void reportError(const char *message)
+{
+    std::cerr << message << std::endl;
+    EventBus::post(EngineEvent::Error, 0, message);
+}
+
+void Engine::addOptions(QCommandLineParser& args)
+{
+    args.addOption(QCommandLineOption("profile",
+        "Load the profile named <name> instead of the first one.", "name"));
+    args.addOption(QCommandLineOption("export-state",
+        "Share live controller state with other programs (see pla_state.h)."));
+    args.addOption(QCommandLineOption("latency-log",
+        "Measure input latency and write the results to <file> on exit.", "file"));
+    args.addOption(QCommandLineOption("trace-file",
+        "Record a trace and write it to <file> on exit (Chrome trace-event JSON).",
+        "file"));
+    args.addOption(QCommandLineOption("poll-rate",
+        "Poll the controller <hz> times per second (default 100, up to 1000).", "hz"));
+    args.addOption(QCommandLineOption("realtime",
+        "Run the input thread with real-time (or high) priority."));
+    args.addOption(QCommandLineOption("cpu",
+        "Pin the input thread to CPU number <n>.", "n"));
+#ifdef PLA_EVDEV
+    args.addOption(QCommandLineOption("evdev",
+        "Read the controller through its event device instead of SDL."));
+#endif
+#ifdef PLA_UINPUT
+    args.addOption(QCommandLineOption("gamepad",
+        "Forward stick and wheel positions to a virtual gamepad."));
+#endif
+    args.addOption(QCommandLineOption("capture",
+        "Record raw controller input to <file>, for replay with plareplay.", "file"));
+}
+
+QStringList Engine::forwardedCommands(const QCommandLineParser& args)
+{
+    QStringList commands;
+    if (args.isSet("profile"))
+        commands.append("profile " + args.value("profile"));
+    return commands;
+}
+
+bool Engine::checkOptions(const QCommandLineParser& args)
+{
+    bool ok = true;
+    if (args.isSet("poll-rate")) {
+        auto hz = args.value("poll-rate").toUInt(&ok);
+        if (!ok || hz == 0) {
+            std::cerr << "--poll-rate must be a number of polls per second." << std::endl;
+            return false;
+        }
+    }
+
+    if (args.isSet("cpu")) {
+        auto cpu = args.value("cpu").toInt(&ok);
+        if (!ok || cpu < 0) {
+            std::cerr << "--cpu must be a CPU number." << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool Engine::start(const QCommandLineParser& args)
+{
+    if (args.isSet("export-state") && !StateExport::open())
+        reportError("Unable to export controller state.");
+
+    latencyLogPath = args.value("latency-log");
+    if (!latencyLogPath.isEmpty())
+        Latency::setEnabled(true);
+
+    tracePath = args.value("trace-file");
+    if (!tracePath.isEmpty())
+        Trace::setEnabled(true);
+    Trace::setThreadName("main");
+
+    if (args.isSet("capture")) {
+        if (capture.open(args.value("capture").toStdString()))
+            Controller::setCapture(&capture);
+        else
+            reportError("Unable to create the capture file.");
+    }
+
+    // Values were validated by checkOptions()
+    if (args.isSet("poll-rate"))
+        Controller::setPollRate(args.value("poll-rate").toUInt());
+    Controller::setThreadPolicy(args.isSet("realtime"),
+        args.isSet("cpu") ? args.value("cpu").toInt() : -1);
+#ifdef PLA_EVDEV
+    Controller::setUseEvdev(args.isSet("evdev"));
+#endif
+#ifdef PLA_UINPUT
+    if (args.isSet("gamepad")) {
+        if (gamepad.open())
+            Controller::setGamepad(&gamepad);
+        else
+            reportError("Unable to create the virtual gamepad.");
+    }
+#endif
+
+    Scheduler::start(args.isSet("realtime"));
+    PointerEngine::start();
+
+    control = new ControlServer;
+    if (!control->listen())
+        reportError("Unable to open the control socket.");
+
+    return Controller::init();
+}
+
+void Engine::stop(void)
+{
+    delete control;
+    control = nullptr;
+
+    Controller::end();
+    PointerEngine::stop();
+    Scheduler::stop();
+    KeySender::stopMacros();
+    Controller::setCapture(nullptr);
+    capture.close();
+#ifdef PLA_UINPUT
+    Controller::setGamepad(nullptr);
+    gamepad.close();
+#endif
+    StateExport::close();
+
+    if (!latencyLogPath.isEmpty()) {
+        std::ofstream log (latencyLogPath.toStdString());
+        Latency::dump(log.is_open() ? log : std::cerr);
+    }
+    if (!tracePath.isEmpty() && !Trace::write(tracePath.toStdString().c_str()))
+        std::cerr << "Unable to write the trace." << std::endl;
+}
+
+long Engine::residentMemory(void)
+{
+#ifdef PLA_WINDOWS
+    return 0;
+#else
+    long pages = 0;
+    QFile statm ("/proc/self/statm");
+    if (statm.open(QFile::ReadOnly)) {
+        auto fields = statm.readAll().split(' ');
+        if (fields.size() > 1)
+            pages = fields[1].toLong();
+    }
+    return pages * (sysconf(_SC_PAGESIZE) / 1024);
+#endif
+}
@@ -0,0 +1,81 @@
+/**
+ * @file engine.h
+ * @brief Starts and stops the input engine, for both PLA_ALT and the
+ * headless daemon.
+ */
+#ifndef ENGINE_H
+#define ENGINE_H
+
+#include "controlserver.h"
+
+#include <QCommandLineParser>
+#include <QString>
+
+/**
+ * @class Engine
+ * @brief Handles the command-line options and start-up/shut-down steps
+ * shared by every program that drives the controller.
+ */
+class Engine
+{
+public:
+    /**
+     * Name of the shared memory that keeps a second copy from driving the
+     * controller.
+     */
+    static constexpr const char *RunGuardKey = "PLA_ALT_runGuardKey";
+
+    /**
+     * Adds the engine's options (--profile, --export-state, --latency-log,
+     * --trace-file, --poll-rate, --realtime, --cpu, --evdev and --capture)
+     * to a parser.
+     */
+    static void addOptions(QCommandLineParser& args);
+
+    /**
+     * Converts the options that also make sense for an instance that is
+     * already running (e.g. --profile) to control socket commands.
+     * @param args The processed parser given to addOptions()
+     */
+    static QStringList forwardedCommands(const QCommandLineParser& args);
+
+    /**
+     * Checks that the engine's options have valid values, printing an error
+     * for the first one that doesn't.
+     * @param args The processed parser given to addOptions()
+     * @return True if every value is valid
+     */
+    static bool checkOptions(const QCommandLineParser& args);
+
+    /**
+     * Applies the engine's options, opens the control socket, then starts
+     * looking for the controller. The current profile should be loaded first.
+     * @param args The processed parser given to addOptions()
+     * @return True if the controller search started
+     */
+    static bool start(const QCommandLineParser& args);
+
+    /**
+     * Gets the control socket's server, or nullptr if not started.
+     */
+    static inline ControlServer *controlServer(void) {
+        return control;
+    }
+
+    /**
+     * Stops the controller, closes the control socket and writes out anything requested by the options.
+     */
+    static void stop(void);
+
+    /**
+     * Gets the process' resident memory in kilobytes, or zero if unknown.
+     */
+    static long residentMemory(void);
+
+private:
+    static QString latencyLogPath;
+    static QString tracePath;
+    static ControlServer *control;
+};
+
+#endif // ENGINE_H
@@ -0,0 +1,89 @@
+# The input engine: controller polling, action tracking and key sending.
+# Shared by PLA_ALT and the programs under tools/, which include this file
+# instead of listing the sources themselves.
+
+QT += network
+INCLUDEPATH += $$PWD $$PWD/input
+
+SOURCES += \
+    $$PWD/controlserver.cpp \
+    $$PWD/engine.cpp \
+    $$PWD/eventbus.cpp \
+    $$PWD/key.cpp \
+    $$PWD/keybackend.cpp \
+    $$PWD/keysender.cpp \
+    $$PWD/latency.cpp \
+    $$PWD/macro.cpp \
+    $$PWD/profile.cpp \
+    $$PWD/serial.cpp \
+    $$PWD/stateexport.cpp \
+    $$PWD/trace.cpp \
+    $$PWD/input/bindingmachine.cpp \
+    $$PWD/input/capture.cpp \
+    $$PWD/input/controller.cpp \
+    $$PWD/input/gamepadoutput.cpp \
+    $$PWD/input/gesturerecognizer.cpp \
+    $$PWD/input/inputfilter.cpp \
+    $$PWD/input/joystick.cpp \
+    $$PWD/input/joysticktracker.cpp \
+    $$PWD/input/periodictimer.cpp \
+    $$PWD/input/pointerengine.cpp \
+    $$PWD/input/pointeroutput.cpp \
+    $$PWD/input/primaryjoysticktracker.cpp \
+    $$PWD/input/scheduler.cpp \
+    $$PWD/input/sdlinputsource.cpp \
+    $$PWD/input/sectorlayout.cpp \
+    $$PWD/input/steeringtracker.cpp \
+    $$PWD/input/threadpolicy.cpp
+
+HEADERS += \
+    $$PWD/config.h \
+    $$PWD/controlserver.h \
+    $$PWD/editing.h \
+    $$PWD/engine.h \
+    $$PWD/eventbus.h \
+    $$PWD/key.h \
+    $$PWD/keybackend.h \
+    $$PWD/keysender.h \
+    $$PWD/latency.h \
+    $$PWD/macro.h \
+    $$PWD/pla_state.h \
+    $$PWD/profile.h \
+    $$PWD/serial.h \
+    $$PWD/stateexport.h \
+    $$PWD/trace.h \
+    $$PWD/input/bindingmachine.h \
+    $$PWD/input/capture.h \
+    $$PWD/input/controller.h \
+    $$PWD/input/controllerstate.h \
+    $$PWD/input/gamepadoutput.h \
+    $$PWD/input/gesturerecognizer.h \
+    $$PWD/input/inputfilter.h \
+    $$PWD/input/inputsource.h \
+    $$PWD/input/joystick.h \
+    $$PWD/input/joysticktracker.h \
+    $$PWD/input/mpscqueue.h \
+    $$PWD/input/periodictimer.h \
+    $$PWD/input/pointerengine.h \
+    $$PWD/input/pointeroutput.h \
+    $$PWD/input/primaryjoysticktracker.h \
+    $$PWD/input/scheduler.h \
+    $$PWD/input/sdlinputsource.h \
+    $$PWD/input/sectorlayout.h \
+    $$PWD/input/seqlock.h \
+    $$PWD/input/steeringtracker.h \
+    $$PWD/input/threadpolicy.h
+
+# Linux can read the controller's event device directly (see --evdev), and
+# present a virtual gamepad through uinput (see --gamepad)
+unix:!macx {
+    DEFINES += PLA_EVDEV PLA_UINPUT
+    SOURCES += \
+        $$PWD/input/evdevinputsource.cpp \
+        $$PWD/input/virtualgamepad.cpp
+    HEADERS += \
+        $$PWD/input/evdevinputsource.h \
+        $$PWD/input/virtualgamepad.h
+}
+
+unix:!macx: LIBS += -lxdo -lSDL2main -lSDL2 -lrt
@@ -0,0 +1,58 @@
+#include "eventbus.h"
+
+#include "trace.h"
+
+MpscQueue<EngineEvent, 256> EventBus::queue;
+std::atomic_bool EventBus::wakePending (false);
+std::atomic<unsigned long> EventBus::droppedCount (0);
+
+static EventBus busInstance;
+
+EventBus *EventBus::instance(void)
+{
+    return &busInstance;
+}
+
+bool EventBus::post(EngineEvent::Type type, int value, const char *text)
+{
+    if (!queue.push(EngineEvent {type, value, text})) {
+        droppedCount.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    // Only the first event of a batch needs to wake the event loop
+    if (!wakePending.exchange(true))
+        QMetaObject::invokeMethod(&busInstance, "drain", Qt::QueuedConnection);
+    return true;
+}
+
+unsigned long EventBus::dropped(void)
+{
+    return droppedCount.load(std::memory_order_relaxed);
+}
+
+void EventBus::drain(void)
+{
+    PLA_TRACE_SCOPE("gui", "EventBus::drain");
+
+    // Cleared first, so an event posted while draining asks for another pass
+    wakePending.store(false);
+
+    EngineEvent event;
+    while (queue.pop(event)) {
+        switch (event.type) {
+        case EngineEvent::ConnectionChanged:
+            emit connectionChanged(event.value != 0);
+            break;
+        case EngineEvent::PgChanged:
+            emit pgChanged(event.value);
+            break;
+        case EngineEvent::ProfileChanged:
+            emit profileChanged();
+            break;
+        case EngineEvent::Error:
+            emit error(QString(event.text));
+            break;
+        }
+    }
+}
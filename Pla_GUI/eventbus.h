@@ -0,0 +1,86 @@
+/**
+ * @file eventbus.h
+ * @brief Delivers engine events to the main thread.
+ */
+#ifndef EVENTBUS_H
+#define EVENTBUS_H
+
+#include "mpscqueue.h"
+
+#include <QObject>
+#include <QString>
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * A change inside the engine that the user interface may want to show.
+ */
+struct EngineEvent {
+    enum Type : std::uint8_t {
+        ConnectionChanged, ///< value is 1 if now connected, else 0
+        PgChanged,         ///< value is the new PG
+        ProfileChanged,    ///< Profile::name() has the new profile
+        Error              ///< text describes the error
+    };
+
+    Type type;
+    int value;
+    /**
+     * Only used by Error. Must point to a string literal, so events can be
+     * copied around without allocating.
+     */
+    const char *text;
+};
+
+/**
+ * @class EventBus
+ * @brief Carries engine events from any thread to the main thread.
+ *
+ * post() pushes onto a lock-free queue and, if the main thread isn't already
+ * due to drain it, wakes the event loop once. The main thread then empties
+ * the queue in one pass, emitting a signal per event. No threads are created
+ * and posting never blocks; if the queue is full the event is dropped and
+ * counted.
+ */
+class EventBus : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * Queues an event. Safe from any thread.
+     * @return False if the queue was full and the event was dropped
+     */
+    static bool post(EngineEvent::Type type, int value = 0, const char *text = nullptr);
+
+    /**
+     * Gets the number of events dropped because the queue was full.
+     */
+    static unsigned long dropped(void);
+
+    /**
+     * Gets the object that emits the events' signals (on the main thread).
+     */
+    static EventBus *instance(void);
+
+signals:
+    void connectionChanged(bool connected);
+    void pgChanged(int pg);
+    void profileChanged(void);
+    void error(const QString& message);
+
+private slots:
+    /**
+     * Emits every queued event.
+     */
+    void drain(void);
+
+private:
+    static MpscQueue<EngineEvent, 256> queue;
+    // Set once a drain has been requested and hasn't started yet
+    static std::atomic_bool wakePending;
+    static std::atomic<unsigned long> droppedCount;
+};
+
+#endif // EVENTBUS_H
@@ -0,0 +1,330 @@
+#include "bindingmachine.h"
+
+#include "config.h"
+#include "scheduler.h"
+
+#include <algorithm>
+#include <vector>
+
+constexpr int BindingMachine::ButtonCount;
+constexpr int BindingMachine::MaxChords;
+constexpr int BindingMachine::MaxFires;
+
+BindingMachine::BindingMachine(void) :
+    KeySender(ButtonCount * TriggerCount + MaxChords),
+    holdTime(config::HoldTime),
+    doubleTapTime(config::DoubleTapTime) {}
+
+BindingMachine::~BindingMachine(void)
+{
+    // Retire pending timeouts; one already running sees the new generation
+    std::vector<std::uint64_t> tasks;
+    {
+        std::lock_guard<std::mutex> lock (stateLock);
+        for (auto& state : buttonStates) {
+            state.generation++;
+            if (state.task != 0)
+                tasks.push_back(state.task);
+        }
+    }
+
+    for (auto task : tasks)
+        Scheduler::cancel(task);
+}
+
+void BindingMachine::setChord(int index, int first, int second)
+{
+    if (index < 0 || index >= MaxChords)
+        return;
+
+    bool valid = first >= 0 && first < ButtonCount && second >= 0 &&
+        second < ButtonCount && first != second;
+    chords[index] = valid ? Chord {first, second} : Chord {};
+}
+
+BindingMachine::Chord BindingMachine::getChord(int index) const
+{
+    if (index < 0 || index >= MaxChords)
+        return {};
+    return chords[index];
+}
+
+void BindingMachine::compile(void)
+{
+    std::unique_lock<std::mutex> lock (stateLock);
+
+    // Nothing pressed under the old tables can be released by the new ones
+    for (int i = 0; i < static_cast<int>(keys.size()); i++)
+        queue(i, false);
+
+    for (auto& state : buttonStates) {
+        state.state = Idle;
+        state.chord = -1;
+        state.deadline = 0;
+        state.task = 0;
+        state.generation++;
+    }
+
+    owned = 0;
+    activeChords = 0;
+    timed = 0;
+
+    std::uint32_t chorded = 0;
+    for (int i = 0; i < MaxChords; i++) {
+        if (chords[i].first >= 0 && keys[chordSlot(i)].first.isValid()) {
+            activeChords |= 1u << i;
+            chorded |= (1u << chords[i].first) | (1u << chords[i].second);
+        }
+    }
+
+    for (int button = 0; button < ButtonCount; button++) {
+        auto& t = table[button];
+        for (auto& row : t) {
+            for (auto& transition : row)
+                transition = Transition {};
+        }
+
+        bool tap = keys[slotOf(button, Tap)].first.isValid();
+        bool hold = keys[slotOf(button, Hold)].first.isValid();
+        bool twice = keys[slotOf(button, DoubleTap)].first.isValid();
+        bool chord = chorded & (1u << button);
+        if (!tap && !hold && !twice && !chord)
+            continue;
+
+        owned |= 1u << button;
+
+        // The tap decision is made on release, so a tap never waits on the
+        // double-tap time
+        t[Idle][Press] = {Pressed, NoAction, hold ? HoldTimer : NoTimer};
+        t[Pressed][Release] = {twice ? Waiting : Idle, tap ? FireTap : PassTap,
+            twice ? DoubleTapTimer : NoTimer};
+
+        if (hold) {
+            t[Pressed][Timeout] = {Held, PressHold};
+            t[Held][Release] = {Idle, ReleaseHold};
+        }
+
+        if (twice) {
+            t[Waiting][Press] = {Doubled, PressDouble};
+            t[Waiting][Timeout] = {Idle};
+            t[Doubled][Release] = {Idle, ReleaseDouble};
+        }
+
+        if (chord) {
+            // The button pressed second comes from Idle or Waiting, the
+            // one pressed first from Pressed
+            t[Idle][ChordPress] = {Chorded};
+            t[Waiting][ChordPress] = {Chorded};
+            t[Pressed][ChordPress] = {Chorded};
+            t[Chorded][Release] = {Idle, ReleaseChord};
+            t[Chorded][ChordEnd] = {Spent};
+            t[Spent][Release] = {Idle};
+        }
+    }
+
+    flush(lock);
+}
+
+std::uint32_t BindingMachine::update(std::uint32_t buttons, std::int64_t timestamp)
+{
+    std::unique_lock<std::mutex> lock (stateLock);
+    if (owned == 0) {
+        lastButtons = buttons;
+        return buttons;
+    }
+
+    auto clock = Scheduler::now();
+    if (timestamp == 0)
+        timestamp = clock;
+
+    // Timeouts that fell before this frame was read happened first
+    if (timed != 0) {
+        for (int i = 0; i < ButtonCount; i++) {
+            if ((timed & (1u << i)) && buttonStates[i].deadline <= timestamp)
+                apply(i, Timeout, buttonStates[i].deadline, clock);
+        }
+    }
+
+    std::uint32_t passed = 0;
+    auto changed = (buttons ^ lastButtons) & owned;
+    lastButtons = buttons;
+
+    // Releases before presses, so a chord sees its buttons' latest states
+    for (auto released = changed & ~buttons; released != 0; released &= released - 1) {
+        int i = 0;
+        while (!(released & (1u << i)))
+            i++;
+        if (apply(i, Release, timestamp, clock))
+            passed |= 1u << i;
+    }
+
+    for (auto pressed = changed & buttons; pressed != 0; pressed &= pressed - 1) {
+        int i = 0;
+        while (!(pressed & (1u << i)))
+            i++;
+        if (!pressChord(i, timestamp, clock))
+            apply(i, Press, timestamp, clock);
+    }
+
+    flush(lock);
+    return (buttons & ~owned) | passed;
+}
+
+bool BindingMachine::apply(int button, Event event, std::int64_t now, std::int64_t clock)
+{
+    auto& state = buttonStates[button];
+    const auto& transition = table[button][state.state][event];
+    if (transition.next == StateCount)
+        return false;
+
+    state.state = transition.next;
+    state.generation++;
+    state.deadline = 0;
+    state.task = 0;
+    timed &= ~(1u << button);
+
+    if (transition.timer != NoTimer) {
+        auto delay = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            transition.timer == HoldTimer ? holdTime : doubleTapTime).count();
+        auto generation = state.generation;
+        state.deadline = now + delay;
+        // Frame timestamps may come from another clock (e.g. a replay), so
+        // the Scheduler is given the same delay from its own time
+        state.task = Scheduler::at(clock + delay,
+            [this, button, generation](std::int64_t) {
+                expire(button, generation);
+            });
+        timed |= 1u << button;
+    }
+
+    switch (transition.action) {
+    case NoAction:
+        break;
+    case FireTap:
+        queue(slotOf(button, Tap), true);
+        queue(slotOf(button, Tap), false);
+        break;
+    case PassTap:
+        return true;
+    case PressHold:
+        queue(slotOf(button, Hold), true);
+        break;
+    case ReleaseHold:
+        queue(slotOf(button, Hold), false);
+        break;
+    case PressDouble:
+        queue(slotOf(button, DoubleTap), true);
+        break;
+    case ReleaseDouble:
+        queue(slotOf(button, DoubleTap), false);
+        break;
+    case ReleaseChord:
+    {
+        auto chord = state.chord;
+        const auto& buttons = chords[chord];
+        auto other = buttons.first == button ? buttons.second : buttons.first;
+        state.chord = -1;
+        buttonStates[other].chord = -1;
+        queue(chordSlot(chord), false);
+        apply(other, ChordEnd, now, clock);
+        break;
+    }
+    }
+
+    return false;
+}
+
+bool BindingMachine::pressChord(int button, std::int64_t now, std::int64_t clock)
+{
+    if (activeChords == 0)
+        return false;
+
+    auto& state = buttonStates[button];
+    if (table[button][state.state][ChordPress].next == StateCount)
+        return false;
+
+    for (int i = 0; i < MaxChords; i++) {
+        if (!(activeChords & (1u << i)))
+            continue;
+
+        int other;
+        if (chords[i].first == button)
+            other = chords[i].second;
+        else if (chords[i].second == button)
+            other = chords[i].first;
+        else
+            continue;
+
+        // The other button must still be undecided, not already a hold or
+        // part of another chord
+        if (buttonStates[other].state != Pressed)
+            continue;
+
+        apply(other, ChordPress, now, clock);
+        apply(button, ChordPress, now, clock);
+        state.chord = i;
+        buttonStates[other].chord = i;
+        queue(chordSlot(i), true);
+        return true;
+    }
+
+    return false;
+}
+
+void BindingMachine::expire(int button, std::uint64_t generation)
+{
+    std::unique_lock<std::mutex> lock (stateLock);
+    auto& state = buttonStates[button];
+    if (state.generation != generation || state.deadline == 0)
+        return;
+
+    apply(button, Timeout, state.deadline, Scheduler::now());
+    flush(lock);
+}
+
+void BindingMachine::flush(std::unique_lock<std::mutex>& lock)
+{
+    if (pendingCount == 0)
+        return;
+
+    Fire fires[MaxFires];
+    auto count = pendingCount;
+    std::copy(pending, pending + count, fires);
+    pendingCount = 0;
+
+    std::lock_guard<std::mutex> order (fireLock);
+    lock.unlock();
+
+    for (int i = 0; i < count; i++)
+        sendKey(fires[i].slot, fires[i].press);
+}
+
+void BindingMachine::save(QSettings& settings) const
+{
+    KeySender::save(settings);
+    settings.setValue("holdtime", static_cast<int>(holdTime.count()));
+    settings.setValue("doubletaptime", static_cast<int>(doubleTapTime.count()));
+    for (int i = 0; i < MaxChords; i++) {
+        settings.beginGroup(QString::fromStdString("chord" + std::to_string(i)));
+        settings.setValue("first", chords[i].first);
+        settings.setValue("second", chords[i].second);
+        settings.endGroup();
+    }
+}
+
+void BindingMachine::load(QSettings& settings)
+{
+    KeySender::load(settings);
+    holdTime = std::chrono::milliseconds(settings.value("holdtime",
+        static_cast<int>(config::HoldTime.count())).toInt());
+    doubleTapTime = std::chrono::milliseconds(settings.value("doubletaptime",
+        static_cast<int>(config::DoubleTapTime.count())).toInt());
+    for (int i = 0; i < MaxChords; i++) {
+        settings.beginGroup(QString::fromStdString("chord" + std::to_string(i)));
+        setChord(i, settings.value("first", -1).toInt(),
+            settings.value("second", -1).toInt());
+        settings.endGroup();
+    }
+
+    compile();
+}
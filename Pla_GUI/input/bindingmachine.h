@@ -0,0 +1,257 @@
+/**
+ * @file bindingmachine.h
+ * @brief Tap, hold, double-tap and chord bindings for the controller's
+ * buttons.
+ */
+#ifndef BINDINGMACHINE_H
+#define BINDINGMACHINE_H
+
+#include "keysender.h"
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+
+/**
+ * @class BindingMachine
+ * @brief Runs each bound button through a state machine, firing keys for
+ * taps, holds, double taps and chords.
+ *
+ * Buttons are numbered as in InputFrame::buttons: 0-2 are the right,
+ * primary and left stick buttons, 3-10 are the PG buttons.
+ *
+ * Every button has three slots (see slotOf()):
+ *     Tap        Pressed and released on release, if the hold time hasn't
+ *                passed. Fires with no delay, even if a double tap is bound.
+ *     Hold       Pressed once the button has been down for the hold time,
+ *                and released with the button.
+ *     DoubleTap  Pressed by a second press within the double-tap time of a
+ *                tap, and released with the button.
+ * A chord (see setChord()) is held while both of its buttons are down. It
+ * is made by pressing the second button while the first is still short of
+ * its hold time, and replaces both buttons' other bindings until released.
+ *
+ * A button with any binding no longer reaches the trackers or selects a PG
+ * when pressed; instead, a tap with no tap binding is passed on as a press
+ * of one frame. Buttons without bindings are passed on as they are.
+ *
+ * The bindings are compiled into one transition table per button, so each
+ * frame costs a table lookup per changed button. Hold and double-tap
+ * timeouts are checked against each frame's timestamp, and are also run
+ * by the Scheduler, so a hold fires at its threshold rather than on the
+ * next frame. Macros are played by KeySender's macro thread, so a long
+ * macro holds up neither the controller nor the Scheduler.
+ */
+class BindingMachine : public KeySender
+{
+public:
+    static constexpr int ButtonCount = 11;
+    static constexpr int MaxChords = 8;
+
+    enum Trigger {
+        Tap,
+        Hold,
+        DoubleTap,
+        TriggerCount
+    };
+
+    struct Chord {
+        // Buttons, or -1 if the chord is unused
+        int first = -1;
+        int second = -1;
+
+        bool operator==(const Chord& other) const {
+            return first == other.first && second == other.second;
+        }
+    };
+
+    BindingMachine(void);
+    virtual ~BindingMachine(void);
+
+    BindingMachine(const BindingMachine&) = delete;
+    BindingMachine& operator=(const BindingMachine&) = delete;
+
+    /**
+     * Gets the key slot of a button's trigger.
+     */
+    static inline int slotOf(int button, Trigger trigger) {
+        return button * TriggerCount + trigger;
+    }
+
+    /**
+     * Gets the key slot of a chord.
+     */
+    static inline int chordSlot(int chord) {
+        return ButtonCount * TriggerCount + chord;
+    }
+
+    /**
+     * Sets the buttons of the index'th chord. Its key is set with setKey()
+     * on chordSlot(index).
+     * @param first, second Two different buttons, or -1 to clear the chord
+     */
+    void setChord(int index, int first, int second);
+    Chord getChord(int index) const;
+
+    inline void setHoldTime(std::chrono::milliseconds time) {
+        holdTime = time;
+    }
+    inline std::chrono::milliseconds getHoldTime(void) const
+    { return holdTime; }
+
+    inline void setDoubleTapTime(std::chrono::milliseconds time) {
+        doubleTapTime = time;
+    }
+    inline std::chrono::milliseconds getDoubleTapTime(void) const
+    { return doubleTapTime; }
+
+    /**
+     * Rebuilds the transition tables. Call after changing keys, chords or
+     * times; any bound key still pressed is released.
+     */
+    void compile(void);
+
+    /**
+     * Runs one frame's buttons through the state machines, firing keys.
+     * @param buttons Bit n set while button n is down
+     * @param timestamp When the buttons were read, in steady_clock
+     * nanoseconds; if zero, the current time
+     * @return The buttons to handle as usual: those without bindings, and
+     * unbound taps
+     */
+    std::uint32_t update(std::uint32_t buttons, std::int64_t timestamp = 0);
+
+    /**
+     * Saves keys, chords and times to the given settings object.
+     */
+    virtual void save(QSettings& settings) const;
+
+    /**
+     * Loads keys, chords and times from the given settings object, then
+     * compiles them.
+     */
+    virtual void load(QSettings& settings);
+
+private:
+    enum State : std::uint8_t {
+        Idle,
+        Pressed,   // Down, neither a tap nor a hold yet
+        Held,      // Hold fired
+        Waiting,   // Tapped; a second press makes a double tap
+        Doubled,   // Double tap fired
+        Chorded,   // Part of a held chord
+        Spent,     // Chord released by the other button; ignored until up
+        StateCount
+    };
+
+    enum Event : std::uint8_t {
+        Press,
+        Release,
+        Timeout,
+        ChordPress,   // Made a chord
+        ChordEnd,     // The chord's other button was released
+        EventCount
+    };
+
+    enum Action : std::uint8_t {
+        NoAction,
+        FireTap,
+        PassTap,
+        PressHold,
+        ReleaseHold,
+        PressDouble,
+        ReleaseDouble,
+        ReleaseChord
+    };
+
+    enum Timer : std::uint8_t {
+        NoTimer,
+        HoldTimer,
+        DoubleTapTimer
+    };
+
+    // Ignored events have next == StateCount
+    struct Transition {
+        State next = StateCount;
+        Action action = NoAction;
+        Timer timer = NoTimer;
+    };
+
+    // A key to press or release, once stateLock is released
+    struct Fire {
+        int slot;
+        bool press;
+    };
+
+    // More than one frame can produce: a timeout, a release and a press
+    // per button, and a chord
+    static constexpr int MaxFires = ButtonCount * 6;
+
+    struct ButtonState {
+        State state = Idle;
+        // The held chord, while Chorded
+        int chord = -1;
+        // Pending timeout, or 0
+        std::int64_t deadline = 0;
+        std::uint64_t task = 0;
+        // Changed on every transition, so stale Scheduler tasks can tell
+        std::uint64_t generation = 0;
+    };
+
+    Transition table[ButtonCount][StateCount][EventCount];
+    ButtonState buttonStates[ButtonCount];
+    Chord chords[MaxChords];
+
+    std::chrono::milliseconds holdTime;
+    std::chrono::milliseconds doubleTapTime;
+
+    // Buttons with any binding, and chords with both buttons and a key
+    std::uint32_t owned = 0;
+    std::uint32_t activeChords = 0;
+    // Buttons with a pending timeout
+    std::uint32_t timed = 0;
+    std::uint32_t lastButtons = 0;
+
+    // Guards the states and pending fires
+    std::mutex stateLock;
+    Fire pending[MaxFires];
+    int pendingCount = 0;
+    // Held while firing, and taken before stateLock is released, so keys
+    // go out in the order their transitions were made
+    std::mutex fireLock;
+
+    /**
+     * Applies an event to a button. Called with stateLock held.
+     * @param now When the event happened, for arming timers
+     * @param clock The Scheduler's time at now
+     * @return True if the button's tap was passed on
+     */
+    bool apply(int button, Event event, std::int64_t now, std::int64_t clock);
+
+    /**
+     * Presses a chord if the button completes one. Called with stateLock
+     * held.
+     * @return True if a chord was pressed
+     */
+    bool pressChord(int button, std::int64_t now, std::int64_t clock);
+
+    /**
+     * Runs a button's timeout if it is still pending, from the Scheduler.
+     */
+    void expire(int button, std::uint64_t generation);
+
+    /**
+     * Adds a key to fire. Called with stateLock held.
+     */
+    inline void queue(int slot, bool press) {
+        if (pendingCount < MaxFires)
+            pending[pendingCount++] = {slot, press};
+    }
+
+    /**
+     * Releases stateLock and fires the queued keys.
+     */
+    void flush(std::unique_lock<std::mutex>& lock);
+};
+
+#endif // BINDINGMACHINE_H
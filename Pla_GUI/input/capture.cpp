@@ -0,0 +1,134 @@
+#include "capture.h"
+
+#include <thread>
+
+static constexpr char Magic[4] = {'P', 'L', 'A', 'C'};
+static constexpr std::uint32_t Version = 1;
+static constexpr unsigned int HeaderSize = 16;
+static constexpr unsigned int FrameSize = 8 + 2 * InputFrame::AxisCount + 2 + 1;
+
+static void putLE(unsigned char *out, std::uint64_t value, unsigned int bytes)
+{
+    for (unsigned int i = 0; i < bytes; i++)
+        out[i] = static_cast<unsigned char>(value >> (8 * i));
+}
+
+static std::uint64_t getLE(const unsigned char *in, unsigned int bytes)
+{
+    std::uint64_t value = 0;
+    for (unsigned int i = 0; i < bytes; i++)
+        value |= static_cast<std::uint64_t>(in[i]) << (8 * i);
+    return value;
+}
+
+CaptureWriter::~CaptureWriter(void)
+{
+    close();
+}
+
+bool CaptureWriter::open(const std::string& path)
+{
+    close();
+
+    file = std::fopen(path.c_str(), "wb");
+    if (file == nullptr)
+        return false;
+
+    unsigned char header[HeaderSize] = {};
+    for (int i = 0; i < 4; i++)
+        header[i] = static_cast<unsigned char>(Magic[i]);
+    putLE(header + 4, Version, 4);
+    putLE(header + 8, FrameSize, 4);
+
+    started = false;
+    return std::fwrite(header, sizeof(header), 1, file) == 1;
+}
+
+void CaptureWriter::close(void)
+{
+    if (file != nullptr) {
+        std::fclose(file);
+        file = nullptr;
+    }
+}
+
+void CaptureWriter::write(const InputFrame& frame)
+{
+    if (file == nullptr)
+        return;
+
+    if (!started) {
+        firstTimestamp = frame.timestamp;
+        started = true;
+    }
+
+    unsigned char record[FrameSize];
+    auto out = record;
+    putLE(out, static_cast<std::uint64_t>(frame.timestamp - firstTimestamp), 8);
+    out += 8;
+    for (int i = 0; i < InputFrame::AxisCount; i++, out += 2)
+        putLE(out, static_cast<std::uint16_t>(frame.axes[i]), 2);
+    putLE(out, frame.buttons, 2);
+    out[2] = frame.pg;
+
+    // Buffered by stdio; flushed when the file is closed
+    std::fwrite(record, sizeof(record), 1, file);
+}
+
+ReplayInputSource::~ReplayInputSource(void)
+{
+    if (file != nullptr)
+        std::fclose(file);
+}
+
+bool ReplayInputSource::open(const std::string& path, bool rt)
+{
+    if (file != nullptr)
+        std::fclose(file);
+
+    file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr)
+        return false;
+
+    unsigned char header[HeaderSize];
+    if (std::fread(header, sizeof(header), 1, file) != 1 ||
+        std::char_traits<char>::compare(reinterpret_cast<char *>(header), Magic, 4) != 0 ||
+        getLE(header + 4, 4) != Version || getLE(header + 8, 4) != FrameSize) {
+        std::fclose(file);
+        file = nullptr;
+        return false;
+    }
+
+    realTime = rt;
+    started = false;
+    return true;
+}
+
+bool ReplayInputSource::read(InputFrame& frame)
+{
+    if (file == nullptr)
+        return false;
+
+    unsigned char record[FrameSize];
+    if (std::fread(record, sizeof(record), 1, file) != 1)
+        return false;
+
+    auto in = record;
+    frame.timestamp = static_cast<std::int64_t>(getLE(in, 8));
+    in += 8;
+    for (int i = 0; i < InputFrame::AxisCount; i++, in += 2)
+        frame.axes[i] = static_cast<std::int16_t>(getLE(in, 2));
+    frame.buttons = static_cast<std::uint16_t>(getLE(in, 2));
+    frame.pg = in[2];
+
+    if (realTime) {
+        if (!started) {
+            start = std::chrono::steady_clock::now() -
+                std::chrono::nanoseconds(frame.timestamp);
+            started = true;
+        }
+        std::this_thread::sleep_until(start + std::chrono::nanoseconds(frame.timestamp));
+    }
+
+    return true;
+}
@@ -0,0 +1,89 @@
+/**
+ * @file capture.h
+ * @brief Recording raw input frames to a file, and replaying them.
+ *
+ * A capture file is a 16-byte header followed by one 25-byte record per
+ * frame, all little-endian:
+ *
+ *     Header: "PLAC"  u32 version  u32 frame size  u32 reserved
+ *     Frame:  i64 timestamp (ns since the first frame)
+ *             i16 axes[7]  u16 buttons  u8 pg
+ */
+#ifndef CAPTURE_H
+#define CAPTURE_H
+
+#include "inputsource.h"
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+/**
+ * @class CaptureWriter
+ * @brief Appends input frames to a capture file.
+ */
+class CaptureWriter
+{
+public:
+    CaptureWriter(void) = default;
+    ~CaptureWriter(void);
+
+    CaptureWriter(const CaptureWriter&) = delete;
+    CaptureWriter& operator=(const CaptureWriter&) = delete;
+
+    /**
+     * Creates (or truncates) a capture file.
+     * @return True if success
+     */
+    bool open(const std::string& path);
+    void close(void);
+
+    bool isOpen(void) const {
+        return file != nullptr;
+    }
+
+    /**
+     * Adds a frame to the file. Timestamps are stored relative to the first
+     * frame written.
+     */
+    void write(const InputFrame& frame);
+
+private:
+    std::FILE *file = nullptr;
+    std::int64_t firstTimestamp = 0;
+    bool started = false;
+};
+
+/**
+ * @class ReplayInputSource
+ * @brief Reads input frames back from a capture file.
+ *
+ * In real-time mode frames are handed out with their original spacing;
+ * otherwise they are returned as fast as they are asked for. Frame
+ * timestamps are always the ones from the file.
+ */
+class ReplayInputSource : public InputSource
+{
+public:
+    ReplayInputSource(void) = default;
+    ~ReplayInputSource(void);
+
+    ReplayInputSource(const ReplayInputSource&) = delete;
+    ReplayInputSource& operator=(const ReplayInputSource&) = delete;
+
+    /**
+     * Opens a capture file.
+     * @return True if the file exists and has a supported header
+     */
+    bool open(const std::string& path, bool realTime);
+
+    bool read(InputFrame& frame) override;
+
+private:
+    std::FILE *file = nullptr;
+    bool realTime = false;
+    bool started = false;
+    std::chrono::steady_clock::time_point start;
+};
+
+#endif // CAPTURE_H
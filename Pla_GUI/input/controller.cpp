@@ -1,27 +1,49 @@
 #include "controller.h"
 #include "config.h"
+#include "eventbus.h"
+#include "latency.h"
 
-#include "mainwindow.h"
+#include "sdlinputsource.h"
+#ifdef PLA_EVDEV
+#include "evdevinputsource.h"
+#endif
 #include "serial.h"
-#include "traymessage.h"
+#include "stateexport.h"
+#include "threadpolicy.h"
+#include "trace.h"
 
+#include <algorithm>
 #include <chrono>
 #include <QKeyEvent>
 #include <QThread>
 
 using namespace std::chrono_literals;
 
-int Controller::currentPG = 0;
+std::atomic_int Controller::currentPG (0);
 std::atomic<SDL_Joystick *> Controller::joystick;
+std::mutex Controller::connectionMutex;
+std::condition_variable Controller::connectionChanged;
 std::atomic_bool Controller::runThreads;
 std::atomic_bool Controller::disableController;
+std::atomic_bool Controller::suspendController (false);
 std::thread Controller::connectionThread;
 std::thread Controller::controllerThread;
+std::atomic<CaptureWriter *> Controller::capture (nullptr);
+#ifdef PLA_UINPUT
+std::atomic<VirtualGamepad *> Controller::gamepad (nullptr);
+#endif
+std::atomic_bool Controller::useEvdev (false);
+std::chrono::nanoseconds Controller::pollPeriod = config::InputUpdateFrequency;
+bool Controller::realtimeThread = false;
+int Controller::threadCpu = -1;
+Seqlock<ControllerState> Controller::liveState;
 
 JoystickTracker Controller::Left;
 JoystickTracker Controller::Right;
 PrimaryJoystickTracker Controller::Primary;
 SteeringTracker Controller::Steering;
+BindingMachine Controller::Bindings;
+GestureRecognizer Controller::Gestures;
 QColor Controller::Color;
 int Controller::ColorBrightness;
 bool Controller::ColorEnable;
@@ -37,15 +59,22 @@ bool Controller::init(void)
     disableController.store(false);
     connectionThread = std::thread(handleConnections);
     controllerThread = std::thread(handleController);
+    return true;
+}
 
-    // Allow time to find connected joystick
-    std::this_thread::sleep_for(2s);
-    return connected();
+bool Controller::waitForConnection(std::chrono::milliseconds timeout)
+{
+    std::unique_lock<std::mutex> lock (connectionMutex);
+    return connectionChanged.wait_for(lock, timeout, [] { return connected(); });
 }
 
 void Controller::end(void)
 {
-    runThreads.store(false);
+    {
+        std::lock_guard<std::mutex> lock (connectionMutex);
+        runThreads.store(false);
+    }
+    connectionChanged.notify_all();
     controllerThread.join();
     connectionThread.join();
 
@@ -60,8 +89,9 @@ bool Controller::connected(void)
 void Controller::selectPG(unsigned int pg)
 {
     if (pg < 8) {
-        currentPG = pg;
+        currentPG.store(pg);
         Primary.setPG(pg);
+        EventBus::post(EngineEvent::PgChanged, pg);
     }
 }
 
@@ -89,6 +119,16 @@ void Controller::save(QSettings& settings)
     Steering.save(settings);
     settings.endGroup();
 
+    // Save button bindings
+    settings.beginGroup("bindings");
+    Bindings.save(settings);
+    settings.endGroup();
+
+    // Save gestures
+    settings.beginGroup("gestures");
+    Gestures.save(settings);
+    settings.endGroup();
+
     settings.endGroup();
     settings.beginGroup("color");
 
@@ -126,6 +166,16 @@ void Controller::load(QSettings& settings)
     Steering.load(settings);
     settings.endGroup();
 
+    // Load button bindings
+    settings.beginGroup("bindings");
+    Bindings.load(settings);
+    settings.endGroup();
+
+    // Load gestures
+    settings.beginGroup("gestures");
+    Gestures.load(settings);
+    settings.endGroup();
+
     settings.endGroup();
     settings.beginGroup("color");
 
@@ -154,6 +204,27 @@ void Controller::updateColor(void)
     }
 }
 
+void Controller::setPollRate(unsigned int hz)
+{
+    hz = std::max(1u, std::min(hz, config::MaxPollRate));
+    pollPeriod = std::chrono::nanoseconds(1000000000 / hz);
+    Latency::setPeriod(pollPeriod);
+}
+
+void Controller::setEnabled(bool enable)
+{
+    disableController.store(!enable);
+    if (!enable)
+        Bindings.compile();
+}
+
+void Controller::setSuspended(bool suspend)
+{
+    suspendController.store(suspend);
+    if (suspend)
+        Bindings.compile();
+}
+
 void Controller::setOperating(bool enable)
 {
     Left.setEnabled(enable);
@@ -164,45 +235,160 @@ void Controller::setOperating(bool enable)
 
 void Controller::handleController(void)
 {
+    Trace::setThreadName("controller");
+    if (realtimeThread && !ThreadPolicy::setRealtime(config::RealtimePriority))
+        EventBus::post(EngineEvent::Error, 0, "Unable to raise the input thread's priority.");
+    if (threadCpu >= 0 && !ThreadPolicy::pinToCpu(threadCpu))
+        EventBus::post(EngineEvent::Error, 0, "Unable to pin the input thread to a CPU.");
+
+    SdlInputSource sdlSource (joystick, currentPG, pollPeriod);
+#ifdef PLA_EVDEV
+    EvdevInputSource evdevSource (joystick, currentPG, pollPeriod);
+#endif
+    bool wasConnected = false;
+
     while (runThreads.load()) {
+        InputSource *source = &sdlSource;
+#ifdef PLA_EVDEV
+        if (useEvdev.load() && evdevSource.available())
+            source = &evdevSource;
+#endif
+
         // Only update if a joystick is connected
-        auto* js = joystick.load();
-        if (js == nullptr) {
-            std::this_thread::sleep_for(config::ConnectionCheckFrequency);
-        } else {
-            SDL_JoystickUpdate();
-
-            // Check for PG button presses
-            for (int i = 3; i <= 10; i++) {
-                if (SDL_JoystickGetButton(js, i)) {
-                    if (currentPG != i - 3) {
-                        currentPG = i - 3;
-                        Primary.setPG(currentPG);
-                    }
-                    break;
-                }
+        InputFrame frame;
+        if (!source->read(frame)) {
+            // Clear the published state once the joystick is gone
+            if (wasConnected) {
+                ControllerState idle {};
+                idle.pg = currentPG.load();
+                idle.timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch()).count();
+                publish(idle, false);
+#ifdef PLA_UINPUT
+                // Center the virtual gamepad rather than leave it deflected
+                auto pad = gamepad.load();
+                if (pad != nullptr)
+                    forwardToGamepad(*pad, idle, false);
+#endif
+                wasConnected = false;
             }
 
-            if (!disableController.load()) {
-                // Update the joystick objects with their respective axes
-                // Y-axis is inverted because joysticks on prototype are upside-down
-                Left.update(-SDL_JoystickGetAxis(js, 3), SDL_JoystickGetAxis(js, 4),
-                    SDL_JoystickGetButton(js, 2));
-                Right.update(-SDL_JoystickGetAxis(js, 2), SDL_JoystickGetAxis(js, 5),
-                    SDL_JoystickGetButton(js, 0));
-                Primary.getPG().update(-SDL_JoystickGetAxis(js, 0), SDL_JoystickGetAxis(js, 1),
-                    SDL_JoystickGetButton(js, 1));
-                Steering.update(SDL_JoystickGetAxis(js, 6));
-            }
+            // Sleep until handleConnections() finds a joystick
+            std::unique_lock<std::mutex> lock (connectionMutex);
+            connectionChanged.wait_for(lock, config::ConnectionCheckFrequency,
+                [] { return connected() || !runThreads.load(); });
+        } else {
+            wasConnected = true;
+
+            auto writer = capture.load();
+            if (writer != nullptr)
+                writer->write(frame);
 
-            std::this_thread::sleep_for(config::InputUpdateFrequency);
+            process(frame);
         }
     }
 }
 
+void Controller::process(const InputFrame& frame)
+{
+    PLA_TRACE_SCOPE("input", "Controller frame");
+    Latency::beginFrame();
+
+    ControllerState state {};
+    state.timestamp = frame.timestamp;
+    state.buttons = frame.buttons;
+
+    // Bound buttons are taken by their bindings; the rest, and taps nothing
+    // is bound to, are handled below as usual
+    bool active = isActive();
+    auto buttons = active ? Bindings.update(frame.buttons, frame.timestamp) :
+        frame.buttons;
+
+    // Paused during the update, which may have armed a timeout after the
+    // pause reset the bindings; reset them again
+    if (active && !isActive())
+        Bindings.compile();
+
+    // Check for PG button presses
+    for (int i = 3; i <= 10; i++) {
+        if (buttons & (1u << i)) {
+            if (currentPG.load() != i - 3)
+                selectPG(i - 3);
+            break;
+        }
+    }
+
+    // Read the axes
+    // Y-axis is inverted because joysticks on prototype are upside-down
+    state.leftX = -frame.axes[3];
+    state.leftY = frame.axes[4];
+    state.rightX = -frame.axes[2];
+    state.rightY = frame.axes[5];
+    state.primaryX = -frame.axes[0];
+    state.primaryY = frame.axes[1];
+    state.wheel = frame.axes[6];
+    state.pg = currentPG.load();
+
+    if (active) {
+        // Update the joystick objects with their respective axes
+        Left.update(state.leftX, state.leftY, (buttons >> 2) & 1, state.timestamp);
+        Right.update(state.rightX, state.rightY, buttons & 1, state.timestamp);
+        Primary.getPG().update(state.primaryX, state.primaryY,
+            (buttons >> 1) & 1, state.timestamp);
+        Gestures.update(state.primaryX, state.primaryY, state.timestamp);
+        Steering.update(state.wheel);
+    }
+
+    state.leftActions = Left.getPressedMask();
+    state.rightActions = Right.getPressedMask();
+    state.primaryActions = Primary.getPG().getPressedMask();
+    state.steeringActions = Steering.getPressedMask();
+#ifdef PLA_UINPUT
+    auto pad = gamepad.load();
+    if (pad != nullptr)
+        forwardToGamepad(*pad, state, active);
+#endif
+    publish(state, true);
+    Latency::endFrame();
+}
+
+void Controller::publish(const ControllerState& state, bool connected)
+{
+    liveState.store(state);
+    StateExport::publish(state, connected);
+}
+
+#ifdef PLA_UINPUT
+void Controller::forwardToGamepad(VirtualGamepad& pad, const ControllerState& state,
+    bool active)
+{
+    std::int32_t axes[VirtualGamepad::AxisCount] {};
+
+    if (active) {
+        auto stick = [&axes](const Joystick& tracker, int x, int y, int axis) {
+            const auto& output = tracker.getGamepadOutput();
+            if (output.enabled) {
+                output.shape(x, y);
+                axes[axis] = x;
+                axes[axis + 1] = y;
+            }
+        };
+        stick(Primary.getPG(), state.primaryX, state.primaryY, VirtualGamepad::PrimaryX);
+        stick(Right, state.rightX, state.rightY, VirtualGamepad::RightX);
+        stick(Left, state.leftX, state.leftY, VirtualGamepad::LeftX);
+
+        const auto& wheel = Steering.getGamepadOutput();
+        if (wheel.enabled)
+            axes[VirtualGamepad::Wheel] = wheel.shape(state.wheel);
+    }
+
+    pad.send(axes);
+}
+#endif
+
 void Controller::handleConnections(void)
 {
-    auto *tray = new TrayMessage();
+    Trace::setThreadName("connections");
 
     while (runThreads.load()) {
         for (SDL_Event event; SDL_PollEvent(&event);) {
@@ -210,21 +396,29 @@ void Controller::handleConnections(void)
             case SDL_JOYDEVICEADDED:
                 if (joystick.load() == nullptr && checkGUID(event.jdevice.which)) {
                     if (Serial::open()) {
-                        tray->show("PLA", "Controller connected!");
-                        joystick.store(SDL_JoystickOpen(event.jdevice.which));
+                        {
+                            std::lock_guard<std::mutex> lock (connectionMutex);
+                            joystick.store(SDL_JoystickOpen(event.jdevice.which));
+                        }
+                        connectionChanged.notify_all();
                         Serial::sendLights(true);
                         selectPG(Serial::getPg());
                         updateColor();
+                        // Announced once connected() is true
+                        EventBus::post(EngineEvent::ConnectionChanged, 1);
+                    } else {
+                        EventBus::post(EngineEvent::Error, 0,
+                            "Unable to open the controller's serial port.");
                     }
                 }
                 break;
             case SDL_JOYDEVICEREMOVED:
                 if (joystick.load() != nullptr) {
-                    tray->show("PLA", "Controller disconnected.");
                     Serial::sendLights(false);
                     Serial::close();
                     SDL_JoystickClose(joystick);
                     joystick.store(nullptr);
+                    EventBus::post(EngineEvent::ConnectionChanged, 0);
                 }
                 break;
             default:
@@ -232,10 +426,11 @@ void Controller::handleConnections(void)
             }
         }
 
-        std::this_thread::sleep_for(config::ConnectionCheckFrequency);
+        std::unique_lock<std::mutex> lock (connectionMutex);
+        connectionChanged.wait_for(lock, config::ConnectionCheckFrequency,
+            [] { return !runThreads.load(); });
     }
 
-    delete tray;
     auto js = joystick.load();
     if (js != nullptr) {
         Serial::sendLights(false);
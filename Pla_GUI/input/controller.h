@@ -11,12 +11,24 @@
 
 #include <SDL2/SDL.h>
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <iostream>
+#include <mutex>
 #include <thread>
 
+#include "bindingmachine.h"
+#include "capture.h"
+#include "controllerstate.h"
+#include "gesturerecognizer.h"
+#include "inputsource.h"
 #include "joysticktracker.h"
 #include "primaryjoysticktracker.h"
+#include "seqlock.h"
 #include "steeringtracker.h"
+#ifdef PLA_UINPUT
+#include "virtualgamepad.h"
+#endif
 
 /**
  * @class Controller
@@ -29,16 +41,28 @@ public:
     static JoystickTracker Right;
     static PrimaryJoystickTracker Primary;
     static SteeringTracker Steering;
+    // Tap, hold, double-tap and chord bindings for the buttons
+    static BindingMachine Bindings;
+    // Gestures made with the primary stick
+    static GestureRecognizer Gestures;
     static QColor Color;
     static int ColorBrightness;
     static bool ColorEnable;
 
     /**
-     * Initializes SDL and searches for a connected controller.
+     * Initializes SDL and starts searching for a connected controller.
+     * Returns immediately; use waitForConnection() to wait for the device.
      * @return True if success
      */
     static bool init(void);
 
+    /**
+     * Blocks until a controller is connected, or until the timeout passes.
+     * @param timeout Longest time to wait
+     * @return True if a controller is connected
+     */
+    static bool waitForConnection(std::chrono::milliseconds timeout);
+
     /**
      * Closes joystick communication and shuts down SDL.
      */
@@ -51,10 +75,26 @@ public:
     static bool connected(void);
 
     /**
-     * If false, controller updates are paused entirely.
+     * If false, controller updates are paused entirely. Pausing releases
+     * any key held by a button binding, and drops pending holds and double
+     * taps.
      */
-    static inline void setEnabled(bool enable) {
-        disableController.store(!enable);
+    static void setEnabled(bool enable);
+    /**
+     * If true, actions are not fired until resumed. Unlike setEnabled(),
+     * which follows the window's focus, this is only changed on request
+     * (e.g. through the control socket). Suspending resets button bindings
+     * as setEnabled(false) does.
+     */
+    static void setSuspended(bool suspend);
+    static inline bool isSuspended(void) {
+        return suspendController.load();
+    }
+    /**
+     * Tests if actions are currently fired: neither disabled nor suspended.
+     */
+    static inline bool isActive(void) {
+        return !disableController.load() && !suspendController.load();
     }
     /**
      * If false, joystick actions are not fired (only X/Y updates).
@@ -62,6 +102,9 @@ public:
     static void setOperating(bool enable);
 
     static void selectPG(unsigned int pg);
+    static inline unsigned int getPG(void) {
+        return currentPG.load();
+    }
 
     /**
      * Saves all settings to the given settings handler.
@@ -80,21 +123,116 @@ public:
      */
     static void updateColor(void);
 
+    /**
+     * Gets a consistent copy of the latest input frame.
+     * Safe to call from any thread, at any rate.
+     */
+    static inline ControllerState snapshot(void) {
+        return liveState.load();
+    }
+
+    /**
+     * Runs one input frame through the trackers, firing any actions.
+     * The controller thread calls this for each frame from the joystick; it
+     * may also be called directly to replay frames when init() was not used.
+     * @param frame The frame to handle
+     */
+    static void process(const InputFrame& frame);
+
+    /**
+     * Sets how often the controller is polled. Must be called before init().
+     * @param hz Polls per second, up to config::MaxPollRate
+     */
+    static void setPollRate(unsigned int hz);
+
+    /**
+     * Sets how the controller thread is scheduled. Must be called before
+     * init().
+     * @param realtime If true, ask for real-time scheduling (or failing
+     * that, a high priority)
+     * @param cpu CPU to pin the thread to, or -1 for any
+     */
+    static inline void setThreadPolicy(bool realtime, int cpu) {
+        realtimeThread = realtime;
+        threadCpu = cpu;
+    }
+
+    /**
+     * Chooses to read the controller through its Linux event device instead
+     * of SDL, where supported. SDL is still used if the device can't be
+     * opened. Takes effect on the next frame.
+     */
+    static inline void setUseEvdev(bool use) {
+        useEvdev.store(use);
+    }
+
+    /**
+     * Saves every frame read from the joystick to the given capture.
+     * @param writer The capture, or nullptr to stop capturing; must stay open
+     * until capturing is stopped and end() is called
+     */
+    static inline void setCapture(CaptureWriter *writer) {
+        capture.store(writer);
+    }
+
+#ifdef PLA_UINPUT
+    /**
+     * Forwards every frame's stick and wheel positions, shaped by each
+     * tracker's GamepadOutput, to the given virtual gamepad.
+     * @param pad The gamepad, or nullptr to stop; must stay open until
+     * forwarding is stopped and end() is called
+     */
+    static inline void setGamepad(VirtualGamepad *pad) {
+        gamepad.store(pad);
+    }
+#endif
+
 private:
     /**
-     * Keeps track of the currently selected PG.
+     * Keeps track of the currently selected PG. Set from the main thread
+     * as well as the controller thread.
      */
-    static int currentPG;
+    static std::atomic_int currentPG;
 
     static std::atomic<SDL_Joystick *> joystick;
+    // Signalled when a joystick connects, or when the threads should stop
+    static std::mutex connectionMutex;
+    static std::condition_variable connectionChanged;
     static std::atomic_bool runThreads;
     static std::atomic_bool disableController;
+    static std::atomic_bool suspendController;
     static std::thread connectionThread;
     static std::thread controllerThread;
 
+    static std::atomic<CaptureWriter *> capture;
+#ifdef PLA_UINPUT
+    static std::atomic<VirtualGamepad *> gamepad;
+#endif
+    static std::atomic_bool useEvdev;
+    static std::chrono::nanoseconds pollPeriod;
+    static bool realtimeThread;
+    static int threadCpu;
+
+    // Latest input frame, published by process()
+    static Seqlock<ControllerState> liveState;
+
     static void handleConnections(void);
     static void handleController(void);
 
+    /**
+     * Makes a frame visible to snapshot() and any state export.
+     */
+    static void publish(const ControllerState& state, bool connected);
+
+#ifdef PLA_UINPUT
+    /**
+     * Sends a frame's positions to the virtual gamepad. While actions are
+     * paused the gamepad is centered.
+     */
+    static void forwardToGamepad(VirtualGamepad& pad, const ControllerState& state,
+        bool active);
+#endif
+
     static bool checkGUID(int id);
 };
 
@@ -0,0 +1,42 @@
+/**
+ * @file controllerstate.h
+ * @brief Snapshot of everything the controller reported in one input frame.
+ */
+#ifndef CONTROLLERSTATE_H
+#define CONTROLLERSTATE_H
+
+#include <cstdint>
+
+/**
+ * @struct ControllerState
+ * @brief One input frame's worth of controller state.
+ *
+ * Axis values are as given to the trackers (range -32767 to 32767, with the
+ * joysticks' x axes already inverted).
+ */
+struct ControllerState {
+    std::int32_t leftX;
+    std::int32_t leftY;
+    std::int32_t rightX;
+    std::int32_t rightY;
+    std::int32_t primaryX;
+    std::int32_t primaryY;
+    std::int32_t wheel;
+
+    // Bit n is set while joystick button n is held
+    std::uint32_t buttons;
+
+    // The selected PG, 0-7
+    std::int32_t pg;
+
+    // Bit n is set while the tracker's action n is pressed
+    std::uint32_t leftActions;
+    std::uint32_t rightActions;
+    std::uint32_t primaryActions;
+    std::uint32_t steeringActions;
+
+    // When the frame was read, in std::chrono::steady_clock nanoseconds
+    std::int64_t timestamp;
+};
+
+#endif // CONTROLLERSTATE_H
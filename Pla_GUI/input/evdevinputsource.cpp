@@ -0,0 +1,322 @@
+#include "evdevinputsource.h"
+
+#include "config.h"
+#include "eventbus.h"
+#include "trace.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/ioctl.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace {
+    template<std::size_t N>
+    bool testBit(const unsigned long (&bits)[N], unsigned int bit) {
+        constexpr auto width = sizeof(unsigned long) * 8;
+        return (bits[bit / width] >> (bit % width)) & 1;
+    }
+
+    constexpr std::size_t bitWords(std::size_t bits) {
+        return (bits + sizeof(unsigned long) * 8 - 1) / (sizeof(unsigned long) * 8);
+    }
+
+    /**
+     * Tests if an event device reports at least as many axes (not counting
+     * hats) as a frame holds. The controller's other nodes, such as its
+     * keyboard, share its IDs but have no axes.
+     */
+    bool hasAxes(int fd) {
+        unsigned long typeBits[bitWords(EV_CNT)] = {};
+        unsigned long absBits[bitWords(ABS_CNT)] = {};
+        if (ioctl(fd, EVIOCGBIT(0, sizeof(typeBits)), typeBits) < 0 ||
+                !testBit(typeBits, EV_ABS) ||
+                ioctl(fd, EVIOCGBIT(EV_ABS, sizeof(absBits)), absBits) < 0)
+            return false;
+
+        int axes = 0;
+        for (unsigned int code = 0; code < ABS_MAX; code++) {
+            if ((code < ABS_HAT0X || code > ABS_HAT3Y) && testBit(absBits, code))
+                axes++;
+        }
+        return axes >= InputFrame::AxisCount;
+    }
+
+    std::int64_t monotonicNow(void) {
+        timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return ts.tv_sec * 1000000000ll + ts.tv_nsec;
+    }
+}
+
+EvdevInputSource::EvdevInputSource(const std::atomic<SDL_Joystick *>& joystick,
+    const std::atomic_int& pg, std::chrono::nanoseconds idlePeriod) :
+    joystick(joystick),
+    pg(pg),
+    idlePeriod(idlePeriod.count())
+{
+
+}
+
+EvdevInputSource::~EvdevInputSource(void)
+{
+    close();
+}
+
+std::string EvdevInputSource::findDevice(void)
+{
+    auto dir = opendir("/dev/input");
+    if (dir == nullptr)
+        return "";
+
+    std::string found;
+    while (auto entry = readdir(dir)) {
+        if (std::strncmp(entry->d_name, "event", 5) != 0)
+            continue;
+
+        auto path = std::string("/dev/input/") + entry->d_name;
+        int fd = ::open(path.c_str(), O_RDONLY | O_NONBLOCK);
+        if (fd == -1)
+            continue;
+
+        input_id id {};
+        bool ok = ioctl(fd, EVIOCGID, &id) == 0 && hasAxes(fd);
+        ::close(fd);
+        if (!ok)
+            continue;
+
+        // DeviceGUID holds the IDs as they appear in SDL's GUID (little endian)
+        for (const auto& guid : config::DeviceGUID) {
+            if (id.vendor == (guid[0] | (guid[1] << 8)) &&
+                id.product == (guid[2] | (guid[3] << 8))) {
+                found = path;
+                break;
+            }
+        }
+        if (!found.empty())
+            break;
+    }
+
+    closedir(dir);
+    return found;
+}
+
+bool EvdevInputSource::open(void)
+{
+    PLA_TRACE_SCOPE("input", "EvdevInputSource::open");
+    auto path = findDevice();
+    if (path.empty())
+        return false;
+
+    deviceFd = ::open(path.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    if (deviceFd == -1)
+        return false;
+
+    // Stamp events with the same clock std::chrono::steady_clock uses
+    int clock = CLOCK_MONOTONIC;
+    ioctl(deviceFd, EVIOCSCLOCKID, &clock);
+
+    // Number axes and buttons the way SDL's Linux driver does: axes in code
+    // order skipping hats, then buttons from BTN_JOYSTICK up followed by
+    // BTN_MISC up to BTN_JOYSTICK
+    unsigned long absBits[bitWords(ABS_CNT)] = {};
+    unsigned long keyBits[bitWords(KEY_CNT)] = {};
+    ioctl(deviceFd, EVIOCGBIT(EV_ABS, sizeof(absBits)), absBits);
+    ioctl(deviceFd, EVIOCGBIT(EV_KEY, sizeof(keyBits)), keyBits);
+
+    std::fill(std::begin(axisIndex), std::end(axisIndex), -1);
+    std::fill(std::begin(buttonIndex), std::end(buttonIndex), -1);
+
+    int axes = 0;
+    for (unsigned int code = 0; code < ABS_MAX && axes < InputFrame::AxisCount; code++) {
+        if (code >= ABS_HAT0X && code <= ABS_HAT3Y)
+            continue;
+        if (testBit(absBits, code)) {
+            axisIndex[code] = static_cast<std::int8_t>(axes);
+            ioctl(deviceFd, EVIOCGABS(code), &axisInfo[axes]);
+            axes++;
+        }
+    }
+
+    int buttons = 0;
+    auto addButton = [&](unsigned int code) {
+        if (buttons < InputFrame::ButtonCount && testBit(keyBits, code))
+            buttonIndex[code] = static_cast<std::int8_t>(buttons++);
+    };
+    for (unsigned int code = BTN_JOYSTICK; code < KEY_MAX; code++)
+        addButton(code);
+    for (unsigned int code = BTN_MISC; code < BTN_JOYSTICK; code++)
+        addButton(code);
+
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    epoll_event ev {};
+    ev.events = EPOLLIN;
+    if (epollFd == -1 || epoll_ctl(epollFd, EPOLL_CTL_ADD, deviceFd, &ev) != 0) {
+        close();
+        return false;
+    }
+
+    eventCount = eventIndex = 0;
+    resync();
+    return true;
+}
+
+void EvdevInputSource::close(void)
+{
+    if (epollFd != -1) {
+        ::close(epollFd);
+        epollFd = -1;
+    }
+    if (deviceFd != -1) {
+        ::close(deviceFd);
+        deviceFd = -1;
+    }
+}
+
+bool EvdevInputSource::available(void)
+{
+    if (joystick.load() == nullptr) {
+        // Disconnected; try again on the next connection
+        close();
+        openFailed = false;
+        return false;
+    }
+
+    if (deviceFd == -1 && !openFailed) {
+        openFailed = !open();
+        if (openFailed) {
+            EventBus::post(EngineEvent::Error, 0, "Unable to open the controller's "
+                "event device; reading it through SDL instead.");
+        }
+    }
+    return deviceFd != -1;
+}
+
+void EvdevInputSource::resync(void)
+{
+    current = {};
+    for (unsigned int code = 0; code < ABS_CNT; code++) {
+        auto axis = axisIndex[code];
+        if (axis >= 0) {
+            input_absinfo info {};
+            if (ioctl(deviceFd, EVIOCGABS(code), &info) == 0)
+                current.axes[axis] = scaleAxis(axis, info.value);
+        }
+    }
+
+    unsigned long keyState[bitWords(KEY_CNT)] = {};
+    ioctl(deviceFd, EVIOCGKEY(sizeof(keyState)), keyState);
+    for (unsigned int code = 0; code < KEY_CNT; code++) {
+        auto button = buttonIndex[code];
+        if (button >= 0 && testBit(keyState, code))
+            current.buttons |= 1u << button;
+    }
+
+    current.timestamp = monotonicNow();
+}
+
+std::int16_t EvdevInputSource::scaleAxis(int axis, int value) const
+{
+    const auto& info = axisInfo[axis];
+    std::int64_t span = static_cast<std::int64_t>(info.maximum) - info.minimum -
+        4ll * info.flat;
+    if (span <= 0)
+        return 0;
+
+    // Map [minimum, maximum] onto [-32767, 32767], with the flat band around
+    // the center reading 0, as SDL's Linux driver does (in doubled units)
+    auto doubled = 2ll * value;
+    auto center = static_cast<std::int64_t>(info.maximum) + info.minimum;
+    auto flat = 2ll * info.flat;
+    std::int64_t offset;
+    if (doubled > center - flat) {
+        if (doubled < center + flat)
+            return 0;
+        offset = doubled - (center + flat);
+    } else {
+        offset = doubled - (center - flat);
+    }
+
+    auto scaled = offset * 32768 / span;
+    return static_cast<std::int16_t>(std::max<std::int64_t>(-32767,
+        std::min<std::int64_t>(32767, scaled)));
+}
+
+bool EvdevInputSource::read(InputFrame& frame)
+{
+    if (deviceFd == -1 && !available())
+        return false;
+
+    for (;;) {
+        // Handle events already read, up to the end of the next update
+        while (eventIndex < eventCount) {
+            const auto& ev = events[eventIndex++];
+            switch (ev.type) {
+            case EV_ABS:
+                if (ev.code < ABS_CNT && axisIndex[ev.code] >= 0)
+                    current.axes[axisIndex[ev.code]] = scaleAxis(axisIndex[ev.code], ev.value);
+                break;
+            case EV_KEY:
+                if (ev.code < KEY_CNT && buttonIndex[ev.code] >= 0) {
+                    auto bit = 1u << buttonIndex[ev.code];
+                    current.buttons = ev.value ? (current.buttons | bit) :
+                        (current.buttons & ~bit);
+                }
+                break;
+            case EV_SYN:
+                if (ev.code == SYN_DROPPED) {
+                    // Skip to the next report, then read the state afresh
+                    eventIndex = eventCount;
+                    resync();
+                } else if (ev.code == SYN_REPORT) {
+                    current.timestamp = ev.time.tv_sec * 1000000000ll +
+                        ev.time.tv_usec * 1000ll;
+                    current.pg = static_cast<std::uint8_t>(pg.load());
+                    lastFrameTime = current.timestamp;
+                    frame = current;
+                    return true;
+                }
+                break;
+            default:
+                break;
+            }
+        }
+
+        // Wait for more events, but repeat the last frame if none come
+        auto now = monotonicNow();
+        auto wait = lastFrameTime + idlePeriod - now;
+        if (wait <= 0) {
+            current.timestamp = now;
+            current.pg = static_cast<std::uint8_t>(pg.load());
+            lastFrameTime = now;
+            frame = current;
+            return true;
+        }
+
+        epoll_event ev;
+        int ready = epoll_wait(epollFd, &ev, 1,
+            static_cast<int>((wait + 999999) / 1000000));
+        if (ready <= 0)
+            continue;
+
+        auto r = ::read(deviceFd, events, sizeof(events));
+        if (r < 0) {
+            if (errno == EAGAIN || errno == EINTR)
+                continue;
+
+            // ENODEV: unplugged; SDL will report the disconnection
+            close();
+            openFailed = true;
+            return false;
+        }
+
+        eventCount = static_cast<int>(r / sizeof(input_event));
+        eventIndex = 0;
+    }
+}
@@ -0,0 +1,97 @@
+/**
+ * @file evdevinputsource.h
+ * @brief Reads input frames straight from the controller's Linux event device.
+ */
+#ifndef EVDEVINPUTSOURCE_H
+#define EVDEVINPUTSOURCE_H
+
+#include "inputsource.h"
+
+#include <SDL2/SDL.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include <linux/input.h>
+
+/**
+ * @class EvdevInputSource
+ * @brief Reads the controller's /dev/input/event* node, bypassing SDL.
+ *
+ * A frame is produced as soon as the kernel reports a complete update
+ * (SYN_REPORT), stamped with the kernel's event time. While the controller is
+ * idle the last frame is repeated once per polling period, so the trackers
+ * still see a resting stick.
+ *
+ * Axes and buttons are numbered the way SDL numbers them, so profiles work
+ * with either source. SDL still detects the controller being connected; this
+ * source opens the event device once the joystick appears.
+ */
+class EvdevInputSource : public InputSource
+{
+public:
+    /**
+     * @param joystick Set while SDL sees the controller connected
+     * @param pg The currently selected PG, recorded in each frame
+     * @param idlePeriod Longest time between frames
+     */
+    EvdevInputSource(const std::atomic<SDL_Joystick *>& joystick,
+        const std::atomic_int& pg, std::chrono::nanoseconds idlePeriod);
+    ~EvdevInputSource(void);
+
+    EvdevInputSource(const EvdevInputSource&) = delete;
+    EvdevInputSource& operator=(const EvdevInputSource&) = delete;
+
+    /**
+     * Tests if frames can be read, opening the device if the controller has
+     * just connected. Opening is only attempted once per connection; if it
+     * fails (e.g. no permission), SDL should be used until reconnection.
+     */
+    bool available(void);
+
+    bool read(InputFrame& frame) override;
+
+    /**
+     * Finds the controller's event device by its USB vendor and product IDs,
+     * skipping nodes without the controller's axes.
+     * @return The device path, or an empty string if not found
+     */
+    static std::string findDevice(void);
+
+private:
+    const std::atomic<SDL_Joystick *>& joystick;
+    const std::atomic_int& pg;
+    std::int64_t idlePeriod;
+
+    int deviceFd = -1;
+    int epollFd = -1;
+    bool openFailed = false;
+
+    // SDL's axis/button number for each event code, or -1
+    std::int8_t axisIndex[ABS_CNT];
+    std::int8_t buttonIndex[KEY_CNT];
+    // Each axis' range and flat band, for scaling to SDL's -32767 to 32767
+    input_absinfo axisInfo[InputFrame::AxisCount];
+
+    // The frame being assembled from events
+    InputFrame current {};
+    std::int64_t lastFrameTime = 0;
+
+    // Events read but not handled yet
+    input_event events[64];
+    int eventCount = 0;
+    int eventIndex = 0;
+
+    bool open(void);
+    void close(void);
+
+    /**
+     * Re-reads every axis and button, after the kernel dropped events.
+     */
+    void resync(void);
+
+    std::int16_t scaleAxis(int axis, int value) const;
+};
+
+#endif // EVDEVINPUTSOURCE_H
@@ -0,0 +1,64 @@
+#include "gamepadoutput.h"
+
+#include "config.h"
+
+#include <algorithm>
+#include <cmath>
+
+GamepadOutput::GamepadOutput(void) :
+    enabled(false),
+    deadzone(config::GamepadDeadzone),
+    curve(1)
+{
+
+}
+
+double GamepadOutput::scale(double distance) const
+{
+    if (distance <= deadzone)
+        return 0;
+
+    auto amount = std::min(1., (distance - deadzone) / (32767. - deadzone));
+    return 32767 * (curve == 1 ? amount : std::pow(amount, curve));
+}
+
+void GamepadOutput::shape(int& x, int& y) const
+{
+    auto distance = std::hypot(x, y);
+    auto scaled = scale(distance);
+    if (scaled == 0) {
+        x = 0;
+        y = 0;
+        return;
+    }
+
+    // Clamp separately; corners of a square gate can still exceed the range
+    auto factor = scaled / distance;
+    x = std::max(-32767, std::min(32767, static_cast<int>(std::lround(x * factor))));
+    y = std::max(-32767, std::min(32767, static_cast<int>(std::lround(y * factor))));
+}
+
+int GamepadOutput::shape(int value) const
+{
+    auto scaled = static_cast<int>(std::lround(scale(std::abs(value))));
+    return value < 0 ? -scaled : scaled;
+}
+
+void GamepadOutput::save(QSettings& settings) const
+{
+    settings.beginGroup("gamepad");
+    settings.setValue("enabled", enabled);
+    settings.setValue("deadzone", deadzone);
+    settings.setValue("curve", curve);
+    settings.endGroup();
+}
+
+void GamepadOutput::load(QSettings& settings)
+{
+    settings.beginGroup("gamepad");
+    enabled = settings.value("enabled", false).toBool();
+    deadzone = settings.value("deadzone", config::GamepadDeadzone).toInt();
+    deadzone = std::max(0, std::min(32766, deadzone));
+    curve = settings.value("curve", 1.0).toDouble();
+    settings.endGroup();
+}
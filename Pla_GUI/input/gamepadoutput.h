@@ -0,0 +1,63 @@
+/**
+ * @file gamepadoutput.h
+ * @brief Shapes stick and wheel positions for the virtual gamepad.
+ */
+#ifndef GAMEPADOUTPUT_H
+#define GAMEPADOUTPUT_H
+
+#include <QSettings>
+
+/**
+ * @struct GamepadOutput
+ * @brief Whether a stick or the wheel is forwarded to the virtual gamepad,
+ * and the deadzone and response curve applied on the way. Saved with its
+ * profile.
+ */
+struct GamepadOutput {
+    /**
+     * If false, the axes are left centered.
+     */
+    bool enabled;
+    /**
+     * Distance from center (in axis units) that still reads as centered.
+     * The rest of the range is stretched to fill -32767 to 32767.
+     */
+    int deadzone;
+    /**
+     * Response curve: the position past the deadzone (0-1) is raised to this
+     * power. 1 is linear; higher values give finer control near the center.
+     */
+    double curve;
+
+    GamepadOutput(void);
+
+    /**
+     * Shapes a stick position radially, so the deadzone is round and
+     * diagonals keep their direction.
+     */
+    void shape(int& x, int& y) const;
+
+    /**
+     * Shapes a single axis, such as the wheel.
+     */
+    int shape(int value) const;
+
+    void save(QSettings& settings) const;
+    void load(QSettings& settings);
+
+    bool operator==(const GamepadOutput& other) const {
+        return enabled == other.enabled && deadzone == other.deadzone &&
+            curve == other.curve;
+    }
+    bool operator!=(const GamepadOutput& other) const {
+        return !(*this == other);
+    }
+
+private:
+    /**
+     * Maps a distance from center to an output distance, 0-32767.
+     */
+    double scale(double distance) const;
+};
+
+#endif // GAMEPADOUTPUT_H
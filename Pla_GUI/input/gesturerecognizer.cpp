@@ -0,0 +1,152 @@
+#include "gesturerecognizer.h"
+
+#include "config.h"
+
+#include <cmath>
+
+constexpr int GestureRecognizer::GestureCount;
+constexpr int GestureRecognizer::HistorySize;
+
+namespace {
+    const double Eighth = std::atan(1.0);
+    const double Pi = 4 * Eighth;
+}
+
+GestureRecognizer::GestureRecognizer(void) :
+    KeySender(GestureCount),
+    radius(config::GestureRadius),
+    circleTime(config::GestureCircleTime),
+    quarterTime(config::GestureQuarterTime),
+    flickTime(config::GestureFlickTime) {}
+
+void GestureRecognizer::update(int x, int y, std::int64_t timestamp)
+{
+    if (!isEnabled)
+        return;
+
+    if (timestamp == 0) {
+        timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    auto dist = static_cast<std::int64_t>(x) * x + static_cast<std::int64_t>(y) * y;
+    auto center = static_cast<std::int64_t>(config::GestureCenter);
+
+    // Back in the center: a flick may be done, and any motion is over
+    if (dist <= center * center) {
+        if (out && flickDirection >= 0 && flickTurned <= 1 &&
+                timestamp - leftCenter <= std::chrono::nanoseconds(flickTime).count())
+            fire(flickSlot(static_cast<Direction>(flickDirection)));
+
+        out = false;
+        flickDirection = -1;
+        restart(-1, timestamp);
+        return;
+    }
+
+    if (!out) {
+        out = true;
+        leftCenter = timestamp;
+        flickTurned = 0;
+    }
+
+    if (dist < static_cast<std::int64_t>(radius) * radius)
+        return;
+
+    // Clockwise from up, as for the trackers' actions
+    auto angle = std::atan2(x, y);
+    auto nearest = static_cast<int>(std::lround(angle / Eighth)) & 7;
+
+    if (eighth < 0) {
+        if (flickDirection < 0)
+            flickDirection = static_cast<int>(std::lround(angle / (2 * Eighth))) & 3;
+        restart(nearest, timestamp);
+        return;
+    }
+
+    // Stay in the current eighth until well past its edge
+    auto offset = std::remainder(angle - eighth * Eighth, 2 * Pi);
+    if (std::abs(offset) < Eighth / 2 + config::StickAngleHysteresis || nearest == eighth)
+        return;
+
+    // Slow polling may skip an eighth; any further is too fast to follow
+    auto delta = (nearest - eighth) & 7;
+    if (delta > 2 && delta < 6) {
+        flickTurned += 4;
+        restart(nearest, timestamp);
+        return;
+    }
+
+    auto step = delta <= 2 ? 1 : -1;
+    auto steps = delta <= 2 ? delta : 8 - delta;
+    flickTurned += steps;
+    for (int i = 0; i < steps; i++)
+        enter((eighth + step) & 7, step, timestamp);
+}
+
+void GestureRecognizer::restart(int from, std::int64_t timestamp)
+{
+    eighth = from;
+    turn = 0;
+    turned = 0;
+    quarterFired = false;
+    historyCount = 0;
+    if (from >= 0)
+        history[historyCount++] = timestamp;
+}
+
+void GestureRecognizer::enter(int next, int step, std::int64_t timestamp)
+{
+    // Turning back starts a new motion from the current eighth
+    if (turn != step) {
+        if (turn != 0)
+            restart(eighth, enteredAgo(0));
+        turn = step;
+    }
+
+    eighth = next;
+    history[historyCount++ & (HistorySize - 1)] = timestamp;
+    turned++;
+
+    // Each check looks back a fixed number of eighths in the ring
+    if (turned >= 8 &&
+            timestamp - enteredAgo(8) <= std::chrono::nanoseconds(circleTime).count()) {
+        fire(circleSlot(turn > 0));
+        turned = 0;
+    } else if (!quarterFired && turned >= 2 && (eighth & 1) == 0 &&
+            timestamp - enteredAgo(2) <= std::chrono::nanoseconds(quarterTime).count()) {
+        quarterFired = true;
+        auto from = static_cast<Direction>(((eighth - 2 * turn) & 7) / 2);
+        fire(quarterSlot(from, turn > 0));
+    }
+}
+
+void GestureRecognizer::fire(int slot)
+{
+    sendKey(slot, true);
+    sendKey(slot, false);
+}
+
+void GestureRecognizer::save(QSettings& settings) const
+{
+    KeySender::save(settings);
+    settings.setValue("enabled", isEnabled);
+    settings.setValue("radius", radius);
+    settings.setValue("circletime", static_cast<int>(circleTime.count()));
+    settings.setValue("quartertime", static_cast<int>(quarterTime.count()));
+    settings.setValue("flicktime", static_cast<int>(flickTime.count()));
+}
+
+void GestureRecognizer::load(QSettings& settings)
+{
+    KeySender::load(settings);
+    isEnabled = settings.value("enabled", false).toBool();
+    radius = settings.value("radius", config::GestureRadius).toInt();
+    circleTime = std::chrono::milliseconds(settings.value("circletime",
+        static_cast<int>(config::GestureCircleTime.count())).toInt());
+    quarterTime = std::chrono::milliseconds(settings.value("quartertime",
+        static_cast<int>(config::GestureQuarterTime.count())).toInt());
+    flickTime = std::chrono::milliseconds(settings.value("flicktime",
+        static_cast<int>(config::GestureFlickTime.count())).toInt());
+    restart(-1, 0);
+}
@@ -0,0 +1,177 @@
+/**
+ * @file gesturerecognizer.h
+ * @brief Recognizes circles, quarter-circles and flicks on a stick.
+ */
+#ifndef GESTURERECOGNIZER_H
+#define GESTURERECOGNIZER_H
+
+#include "keysender.h"
+
+#include <chrono>
+#include <cstdint>
+
+/**
+ * @class GestureRecognizer
+ * @brief Watches a stick's samples for gestures and fires a key for each
+ * one recognized.
+ *
+ * Past the gesture radius the stick's angle is followed in eighths of a
+ * turn (0 is up, going clockwise, as for the trackers). Every eighth
+ * entered goes into a fixed ring of timestamps, so each sample is checked
+ * against the ring in constant time, and a gesture fires on the sample that
+ * completes it:
+ *     Circle   Eight eighths turned one way within the circle time.
+ *     Quarter  A turn from one of up/right/down/left to the next within the
+ *              quarter time. Only the first quarter of each motion fires, so
+ *              a circle starts with one quarter rather than four.
+ *     Flick    Out past the radius and back to the center within the flick
+ *              time, turning at most one eighth.
+ * A motion ends when the stick returns to the center or turns back. Keys
+ * are tapped (pressed and released) when their gesture fires; the stick's
+ * own actions are unaffected.
+ *
+ * Key slots: see circleSlot(), quarterSlot() and flickSlot().
+ */
+class GestureRecognizer : public KeySender
+{
+public:
+    static constexpr int GestureCount = 14;
+
+    // Directions, for quarters and flicks
+    enum Direction {
+        Up,
+        Right,
+        Down,
+        Left
+    };
+
+    GestureRecognizer(void);
+
+    /**
+     * If false (the default), samples are ignored.
+     */
+    inline void setEnabled(bool yes) {
+        isEnabled = yes;
+    }
+    inline bool getEnabled(void) const
+    { return isEnabled; }
+
+    static inline int circleSlot(bool clockwise) {
+        return clockwise ? 0 : 1;
+    }
+
+    /**
+     * Gets the slot of a quarter-circle.
+     * @param from The direction the quarter starts from
+     * @param clockwise The way it turns
+     */
+    static inline int quarterSlot(Direction from, bool clockwise) {
+        return 2 + from * 2 + (clockwise ? 0 : 1);
+    }
+
+    static inline int flickSlot(Direction direction) {
+        return 10 + direction;
+    }
+
+    /**
+     * Sets the distance from the center (in axis units) the stick must pass
+     * for its angle to be followed.
+     */
+    inline void setRadius(int r) {
+        radius = r;
+    }
+    inline int getRadius(void) const
+    { return radius; }
+
+    /**
+     * Longest times a circle, quarter and flick may take.
+     */
+    inline void setCircleTime(std::chrono::milliseconds time) {
+        circleTime = time;
+    }
+    inline std::chrono::milliseconds getCircleTime(void) const
+    { return circleTime; }
+    inline void setQuarterTime(std::chrono::milliseconds time) {
+        quarterTime = time;
+    }
+    inline std::chrono::milliseconds getQuarterTime(void) const
+    { return quarterTime; }
+    inline void setFlickTime(std::chrono::milliseconds time) {
+        flickTime = time;
+    }
+    inline std::chrono::milliseconds getFlickTime(void) const
+    { return flickTime; }
+
+    /**
+     * Checks the stick's newest sample, firing a gesture's key if it
+     * completes one.
+     * @param x, y The position; positive y is up
+     * @param timestamp When the position was read, in steady_clock
+     * nanoseconds; if zero, the current time
+     */
+    void update(int x, int y, std::int64_t timestamp = 0);
+
+    /**
+     * Saves keys and settings to the given settings object.
+     */
+    virtual void save(QSettings& settings) const;
+
+    /**
+     * Loads keys and settings from the given settings object.
+     */
+    virtual void load(QSettings& settings);
+
+private:
+    // Enough eighths for a circle, with room to spare; a power of two
+    static constexpr int HistorySize = 16;
+
+    bool isEnabled = false;
+    int radius;
+    std::chrono::milliseconds circleTime;
+    std::chrono::milliseconds quarterTime;
+    std::chrono::milliseconds flickTime;
+
+    // When each eighth of the current motion was entered
+    std::int64_t history[HistorySize];
+    unsigned int historyCount = 0;
+
+    // The eighth the stick is in, or -1 until it passes the radius
+    int eighth = -1;
+    // The current motion's turn: +1 clockwise, -1 counter-clockwise, or 0
+    int turn = 0;
+    // Eighths turned since the motion started, or since its last circle
+    int turned = 0;
+    bool quarterFired = false;
+
+    // Set while outside the center
+    bool out = false;
+    std::int64_t leftCenter = 0;
+    // Flick direction, once past the radius; -1 before
+    int flickDirection = -1;
+    // Eighths turned since leaving the center
+    int flickTurned = 0;
+
+    /**
+     * Starts a new motion, in the given eighth (or none).
+     */
+    void restart(int from, std::int64_t timestamp);
+
+    /**
+     * Records entering an eighth, one step from the last one.
+     */
+    void enter(int next, int step, std::int64_t timestamp);
+
+    /**
+     * Gets when the eighth entered the given number of steps ago was entered.
+     */
+    inline std::int64_t enteredAgo(int steps) const {
+        return history[(historyCount - 1 - steps) & (HistorySize - 1)];
+    }
+
+    /**
+     * Presses and releases a slot's key.
+     */
+    void fire(int slot);
+};
+
+#endif // GESTURERECOGNIZER_H
@@ -0,0 +1,75 @@
+#include "inputfilter.h"
+
+#include "config.h"
+
+#include <cmath>
+
+InputConditioning::InputConditioning(void) :
+    minCutoff(config::StickFilterMinCutoff),
+    beta(config::StickFilterBeta),
+    radialBand(config::StickRadialHysteresis),
+    angleBand(config::StickAngleHysteresis)
+{
+
+}
+
+void InputConditioning::save(QSettings& settings) const
+{
+    settings.beginGroup("conditioning");
+    settings.setValue("mincutoff", minCutoff);
+    settings.setValue("beta", beta);
+    settings.setValue("radialband", radialBand);
+    settings.setValue("angleband", angleBand);
+    settings.endGroup();
+}
+
+void InputConditioning::load(QSettings& settings)
+{
+    settings.beginGroup("conditioning");
+    minCutoff = settings.value("mincutoff", config::StickFilterMinCutoff).toDouble();
+    beta = settings.value("beta", config::StickFilterBeta).toDouble();
+    radialBand = settings.value("radialband", config::StickRadialHysteresis).toInt();
+    angleBand = settings.value("angleband", config::StickAngleHysteresis).toDouble();
+    settings.endGroup();
+}
+
+static double smoothingFactor(double dt, double cutoff)
+{
+    auto tau = 1 / (6.283185307 * cutoff);
+    return 1 / (1 + tau / dt);
+}
+
+double OneEuroFilter::filter(double value, double dt, double minCutoff, double beta)
+{
+    auto derivative = (value - lastValue) / dt;
+    lastDerivative += smoothingFactor(dt, config::StickFilterDerivativeCutoff) *
+        (derivative - lastDerivative);
+
+    auto cutoff = minCutoff + beta * std::abs(lastDerivative);
+    lastValue += smoothingFactor(dt, cutoff) * (value - lastValue);
+    return lastValue;
+}
+
+void OneEuroFilter::reset(double value)
+{
+    lastValue = value;
+    lastDerivative = 0;
+}
+
+void StickFilter::apply(double& x, double& y, std::int64_t timestamp,
+    const InputConditioning& settings)
+{
+    auto dt = (timestamp - lastTimestamp) / 1e9;
+    lastTimestamp = timestamp;
+
+    // Start over after a gap (first sample, reconnection, PG change), rather
+    // than smoothing from a stale position
+    if (settings.minCutoff <= 0 || dt <= 0 || dt > config::StickFilterMaxGap) {
+        fx.reset(x);
+        fy.reset(y);
+        return;
+    }
+
+    x = fx.filter(x, dt, settings.minCutoff, settings.beta);
+    y = fy.filter(y, dt, settings.minCutoff, settings.beta);
+}
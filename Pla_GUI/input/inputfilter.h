@@ -0,0 +1,107 @@
+/**
+ * @file inputfilter.h
+ * @brief Conditions raw stick positions before they are classified.
+ */
+#ifndef INPUTFILTER_H
+#define INPUTFILTER_H
+
+#include <QSettings>
+
+#include <cstdint>
+
+/**
+ * @struct InputConditioning
+ * @brief A stick's filter and hysteresis settings, saved with its profile.
+ */
+struct InputConditioning {
+    /**
+     * One-euro filter cutoff while the stick is still, in Hz. Lower values
+     * remove more jitter but add lag to slow movement. Zero turns the filter
+     * off.
+     */
+    double minCutoff;
+    /**
+     * How quickly the cutoff rises with stick speed, in Hz per (unit/s).
+     * Higher values let fast flicks through with less lag.
+     */
+    double beta;
+    /**
+     * Distance (in axis units) the stick must move past a threshold ring
+     * before it counts as crossed, in either direction.
+     */
+    int radialBand;
+    /**
+     * Angle (in radians) the stick must move past a direction boundary before
+     * the direction changes.
+     */
+    double angleBand;
+
+    InputConditioning(void);
+
+    void save(QSettings& settings) const;
+    void load(QSettings& settings);
+
+    bool operator==(const InputConditioning& other) const {
+        return minCutoff == other.minCutoff && beta == other.beta &&
+            radialBand == other.radialBand && angleBand == other.angleBand;
+    }
+    bool operator!=(const InputConditioning& other) const {
+        return !(*this == other);
+    }
+};
+
+/**
+ * @class OneEuroFilter
+ * @brief Low-pass filter whose cutoff rises with the signal's speed.
+ *
+ * Based on Casiez et al., "1€ Filter: A Simple Speed-based Low-pass Filter
+ * for Noisy Input in Interactive Systems" (CHI 2012). Slow movement is
+ * smoothed heavily; fast movement passes through with little lag.
+ */
+class OneEuroFilter
+{
+public:
+    /**
+     * Filters the next sample.
+     * @param value The raw sample
+     * @param dt Seconds since the previous sample
+     * @param minCutoff Cutoff at rest, in Hz
+     * @param beta Cutoff increase per unit/s of speed
+     * @return The filtered sample
+     */
+    double filter(double value, double dt, double minCutoff, double beta);
+
+    /**
+     * Restarts the filter at the given value.
+     */
+    void reset(double value);
+
+private:
+    double lastValue = 0;
+    double lastDerivative = 0;
+};
+
+/**
+ * @class StickFilter
+ * @brief A one-euro filter for each of a stick's axes.
+ */
+class StickFilter
+{
+public:
+    /**
+     * Filters a position in place.
+     * @param x The x-axis position
+     * @param y The y-axis position
+     * @param timestamp The sample time, in steady_clock nanoseconds
+     * @param settings Filter parameters
+     */
+    void apply(double& x, double& y, std::int64_t timestamp,
+        const InputConditioning& settings);
+
+private:
+    OneEuroFilter fx;
+    OneEuroFilter fy;
+    std::int64_t lastTimestamp = 0;
+};
+
+#endif // INPUTFILTER_H
@@ -0,0 +1,48 @@
+/**
+ * @file inputsource.h
+ * @brief Where Controller gets its raw input frames from.
+ */
+#ifndef INPUTSOURCE_H
+#define INPUTSOURCE_H
+
+#include <cstdint>
+
+/**
+ * @struct InputFrame
+ * @brief The raw values read from the controller in one poll.
+ */
+struct InputFrame {
+    static constexpr int AxisCount = 7;
+    static constexpr int ButtonCount = 11;
+
+    // When the frame was read, in std::chrono::steady_clock nanoseconds
+    std::int64_t timestamp;
+
+    // Axes as reported by SDL (not inverted)
+    std::int16_t axes[AxisCount];
+
+    // Bit n is set while button n is held
+    std::uint16_t buttons;
+
+    // The PG selected when the frame was read; only applied on replay
+    std::uint8_t pg;
+};
+
+/**
+ * @class InputSource
+ * @brief Provides input frames, paced the way the source wants them handled.
+ */
+class InputSource
+{
+public:
+    virtual ~InputSource(void) = default;
+
+    /**
+     * Waits until the next frame is due, then reads it.
+     * @param frame Where to put the frame
+     * @return False if there is no frame (disconnected, or end of a recording)
+     */
+    virtual bool read(InputFrame& frame) = 0;
+};
+
+#endif // INPUTSOURCE_H
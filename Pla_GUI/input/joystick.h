@@ -5,6 +5,8 @@
 #ifndef JOYSTICK_H
 #define JOYSTICK_H
 
+#include "gamepadoutput.h"
+
 #include <QSettings>
 
 /**
@@ -31,6 +33,11 @@ protected:
      */
     int farThreshold;
 
+    /**
+     * How the joystick's position is forwarded to the virtual gamepad.
+     */
+    GamepadOutput gamepadOutput;
+
 public:
     /**
      * Gets the short threshold.
@@ -53,6 +60,12 @@ public:
      */
     void setFarThreshold(int value);
 
+    inline void setGamepadOutput(const GamepadOutput& settings) {
+        gamepadOutput = settings;
+    }
+    inline const GamepadOutput& getGamepadOutput(void) const
+    { return gamepadOutput; }
+
 protected:
     /**
      * Loads threshold values from the given settings object.
@@ -1,6 +1,8 @@
 #include "joysticktracker.h"
 #include "config.h"
+#include "latency.h"
 
+#include <chrono>
 #include <cmath> // sqrt()
 #include <iostream>
 
@@ -108,79 +110,137 @@ void JoystickTracker::setDiagonals(bool enable)
 //        << getActionIndex(toState(lastX), toState(lastY)) << std::endl;
 //}
 
-void JoystickTracker::update(int x, int y, int pressed)
+int JoystickTracker::ringOf(double dist, int current, int band) const
 {
-    // 1. Update lastX/Y, and check travel speed.
-    {
-        if (!isEnabled) {
-            lastX = x;
-            lastY = y;
-            return;
+    // Rings the stick is already past are easier to stay in
+    auto shortLimit = shortThreshold + (current >= 1 ? -band : band);
+    auto farLimit = farThreshold + (current >= 2 ? -band : band);
+
+    if (dist < shortLimit)
+        return 0;
+    return dist < farLimit ? 1 : 2;
+}
+
+int JoystickTracker::directionOf(double angle) const
+{
+    int vert, horz;
+    int vsign = angle < 0 ? -1 : 1;
+    auto absang = std::abs(angle);
+
+    do {
+        if (absang < primaryAngle / 2) {
+            // Right
+            vert = 0;
+            horz = 1;
+            break;
         }
+        absang -= primaryAngle / 2;
+        if (absang < 1.570796 - primaryAngle) {
+            // Up/down right
+            vert = vsign;
+            horz = 1;
+            break;
+        }
+        absang -= 1.570796 - primaryAngle;
+        if (absang < primaryAngle) {
+            // Up/down
+            vert = vsign;
+            horz = 0;
+            break;
+        }
+        absang -= primaryAngle;
+        if (absang < 1.570796 - primaryAngle) {
+            // Up/down left
+            vert = vsign;
+            horz = -1;
+            break;
+        }
+        // Left
+        vert = 0;
+        horz = -1;
+    } while (false);
+
+    return (horz + 1) * 3 + (vert + 1);
+}
+
+void JoystickTracker::update(int x, int y, int pressed, std::int64_t timestamp)
+{
+    // 1. Smooth the position. The filter keeps running while disabled, so
+    //    it is settled when re-enabled.
+    if (timestamp == 0) {
+        timestamp = lastTimestamp + std::chrono::duration_cast<std::chrono::nanoseconds>(
+            config::InputUpdateFrequency).count();
+    }
+    lastTimestamp = timestamp;
 
-        auto dx = x - lastX;
-        auto dy = y - lastY;
-        lastX = x;
-        lastY = y;
+    double fx = x;
+    double fy = y;
+    filter.apply(fx, fy, timestamp, conditioning);
 
-        // Don't act if we're moving too quick (or are disabled)
-        auto travelDistance = std::sqrt(dx * dx + dy * dy);
-        if (travelDistance > config::JoystickSpeedThreshold)
-            return;
+    if (!isEnabled)
+        return;
+
+    // Sticks moving the pointer keep only their button
+    if (pointerOutput.mode != PointerOutput::Keys) {
+        if (lastRing != 0) {
+            releaseActions();
+            lastRing = 0;
+        }
+        updateButton(pressed);
+        return;
+    }
+
+    if (!layout.isEmpty()) {
+        updateRadial(fx, fy, x, y);
+        updateButton(pressed);
+        return;
     }
 
     // 2. Convert joystick position to action positions.
     //    These range -2 to 2: +-2 for far threshold,
     //    +-1 for short, 0 for no action.
-    int vert, horz;
-    auto dist = std::min(std::sqrt(x * x + y * y), 32767.);
-    if (dist < shortThreshold) {
-        vert = 0;
-        horz = 0;
-    } else {
-        int mult = dist < farThreshold ? 1 : 2;
-        auto ang = std::atan2(y, x);
+    //    Crossing a ring or direction boundary takes going a band past it.
+    auto ring = ringOf(std::min(std::sqrt(fx * fx + fy * fy), 32767.), lastRing,
+        conditioning.radialBand);
+    auto direction = 4; // Centered
+    if (ring != 0) {
+        auto ang = std::atan2(fy, fx);
+        direction = directionOf(ang);
 
-        if (std::isnan(ang)) {
-            vert = 0;
-            horz = 0;
-        } else {
-            auto absang = std::abs(ang);
-            do {
-                if (absang < primaryAngle / 2) {
-                    // Right
-                    vert = 0;
-                    horz = mult;
-                    break;
-                }
-                absang -= primaryAngle / 2;
-                if (absang < 1.570796 - primaryAngle) {
-                    // Up/down right
-                    vert = mult * (ang < 0 ? -1 : 1);
-                    horz = mult;
-                    break;
-                }
-                absang -= 1.570796 - primaryAngle;
-                if (absang < primaryAngle) {
-                    // Up/down
-                    vert = mult * (ang < 0 ? -1 : 1);
-                    horz = 0;
-                    break;
-                }
-                absang -= primaryAngle;
-                if (absang < 1.570796 - primaryAngle) {
-                    // Up/down left
-                    vert = mult * (ang < 0 ? -1 : 1);
-                    horz = -mult;
-                    break;
-                }
-                // Left
-                vert = 0;
-                horz = -mult;
-            } while (false);
+        // Stay with the previous direction while within the band of it
+        auto band = conditioning.angleBand;
+        if (lastRing != 0 && direction != lastDirection && band > 0) {
+            auto wrap = [](double a) {
+                return a > 3.141593 ? a - 6.283185 : (a < -3.141593 ? a + 6.283185 : a);
+            };
+            if (directionOf(wrap(ang + band)) == lastDirection ||
+                directionOf(wrap(ang - band)) == lastDirection)
+                direction = lastDirection;
         }
     }
 
+    // For diagnostics, count how often the unconditioned position would have
+    // changed action, next to how often it actually did
+    if (Latency::isEnabled()) {
+        auto rawRing = ringOf(std::min(std::sqrt(double(x) * x + double(y) * y), 32767.),
+            lastRawRing, 0);
+        auto rawDirection = rawRing != 0 ? directionOf(std::atan2(y, x)) : 4;
+        bool rawChanged = rawRing != lastRawRing ||
+            (rawRing != 0 && rawDirection != lastRawDirection);
+        bool changed = ring != lastRing || (ring != 0 && direction != lastDirection);
+        Latency::countTransition(rawChanged, changed);
+        lastRawRing = rawRing;
+        lastRawDirection = rawDirection;
+    }
+
+    lastRing = ring;
+    lastDirection = direction;
+
+    int horz = (direction / 3 - 1) * ring;
+    int vert = (direction % 3 - 1) * ring;
+
+    Latency::mark(Latency::Classify);
+
     // 3. Use action positions to determine presses and releases.
     if (useDiagonals) {
         int bits = getActionBits(horz, vert);
@@ -205,17 +265,79 @@ void JoystickTracker::update(int x, int y, int pressed)
         sendKey(index, true);
     }
 
+    updateButton(pressed);
+}
+
+void JoystickTracker::updateButton(int pressed)
+{
     if (lastPressed != pressed) {
         if (!isButtonSticky) {
-            sendKey(16, pressed);
+            sendKey(ButtonAction, pressed);
         } else if (pressed) {
             stickyState ^= true;
-            sendKey(16, stickyState);
+            sendKey(ButtonAction, stickyState);
         }
         lastPressed = pressed;
     }
 }
 
+void JoystickTracker::updateRadial(double fx, double fy, int x, int y)
+{
+    auto ring = layout.ringOf(std::min(std::sqrt(fx * fx + fy * fy), 32767.),
+        lastRing - 1, conditioning.radialBand);
+    int sector = -1;
+    if (ring >= 0)
+        sector = layout.sectorOf(ring, fx, fy, ring == lastRing - 1 ? lastDirection : -1);
+
+    if (Latency::isEnabled()) {
+        auto rawRing = layout.ringOf(std::min(std::sqrt(double(x) * x + double(y) * y),
+            32767.), lastRawRing - 1, 0);
+        auto rawSector = rawRing >= 0 ? layout.sectorOf(rawRing, x, y, -1) : -1;
+        Latency::countTransition(rawRing != lastRawRing - 1 || rawSector != lastRawDirection,
+            ring != lastRing - 1 || sector != lastDirection);
+        lastRawRing = rawRing + 1;
+        lastRawDirection = rawSector;
+    }
+
+    lastRing = ring + 1;
+    lastDirection = sector;
+
+    Latency::mark(Latency::Classify);
+
+    auto action = ring >= 0 ? RadialActionBase + layout.actionIndex(ring, sector) : -1;
+    if (action != lastRadialAction) {
+        sendKey(lastRadialAction, false);
+        sendKey(action, true);
+        lastRadialAction = action;
+    }
+}
+
+void JoystickTracker::releaseActions(void)
+{
+    for (int i = 0; i < ButtonAction; i++)
+        sendKey(i, false);
+    for (int i = RadialActionBase; i < static_cast<int>(keys.size()); i++)
+        sendKey(i, false);
+    lastRadialAction = -1;
+}
+
+void JoystickTracker::setLayout(const SectorLayout& newLayout)
+{
+    if (newLayout == layout)
+        return;
+
+    releaseActions();
+    layout = newLayout;
+    layout.setBand(conditioning.angleBand);
+    resizeKeys(RadialActionBase + layout.actionCount());
+
+    // Ring and direction mean different things with and without a layout
+    lastRing = 0;
+    lastDirection = 0;
+    lastRawRing = 0;
+    lastRawDirection = 0;
+}
+
 void JoystickTracker::save(QSettings &settings) const
 {
     KeySender::save(settings);
@@ -225,10 +347,19 @@ void JoystickTracker::save(QSettings &settings) const
     settings.setValue("diagonals", useDiagonals);
     settings.setValue("sticky", isButtonSticky);
     settings.setValue("pangle", primaryAngle);
+    conditioning.save(settings);
+    gamepadOutput.save(settings);
+    pointerOutput.save(settings);
+    layout.save(settings);
 }
 
 void JoystickTracker::load(QSettings &settings)
 {
+    // The layout sets how many keys there are to load
+    SectorLayout loaded;
+    loaded.load(settings);
+    setLayout(loaded);
+
     KeySender::load(settings);
     loadThresholds(settings);
 
@@ -236,4 +367,8 @@ void JoystickTracker::load(QSettings &settings)
     useDiagonals = settings.value("diagonals", false).toBool();
     isButtonSticky = settings.value("sticky", false).toBool();
     primaryAngle = settings.value("pangle", 0.7853982).toDouble();
+    conditioning.load(settings);
+    layout.setBand(conditioning.angleBand);
+    gamepadOutput.load(settings);
+    pointerOutput.load(settings);
 }
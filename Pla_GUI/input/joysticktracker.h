@@ -6,8 +6,13 @@
 #ifndef JOYSTICKTRACKER_H
 #define JOYSTICKTRACKER_H
 
+#include "inputfilter.h"
 #include "joystick.h"
 #include "keysender.h"
+#include "pointeroutput.h"
+#include "sectorlayout.h"
+
+#include <cstdint>
 
 /**
  * @class JoystickTracker
@@ -26,10 +31,24 @@
  *     14  6       2  10
  *         5   4   3
  *     13     12      11
+ *
+ * Positions are smoothed by a one-euro filter, and the threshold rings and
+ * direction boundaries have hysteresis, so a stick resting on an edge
+ * doesn't chatter between two actions (see InputConditioning).
+ *
+ * In pointer or scroll mode the stick's direction actions are not fired; the
+ * PointerEngine moves the pointer instead (see PointerOutput).
+ *
+ * With a SectorLayout set, the directions above are replaced by the layout's
+ * sectors, whose actions start at RadialActionBase (after the button).
  */
 class JoystickTracker : public Joystick, public KeySender
 {
 public:
+    // Index of the stick button's action, and of the first radial action
+    static constexpr int ButtonAction = 16;
+    static constexpr int RadialActionBase = 17;
+
     /**
      * Constructs a tracker with the given initial sequencer and diagonal
      * states.
@@ -60,6 +79,8 @@ public:
     inline void setEnabled(bool yes) {
         isEnabled = yes;
     }
+    inline bool getEnabled(void) const
+    { return isEnabled; }
 
     inline void setPrimaryAngle(double angle) {
         primaryAngle = angle;
@@ -84,14 +105,38 @@ public:
     inline bool getButtonSticky(void) const
     { return isButtonSticky; }
 
+    inline void setConditioning(const InputConditioning& settings) {
+        conditioning = settings;
+        layout.setBand(conditioning.angleBand);
+    }
+    inline const InputConditioning& getConditioning(void) const
+    { return conditioning; }
+
+    inline void setPointerOutput(const PointerOutput& settings) {
+        pointerOutput = settings;
+    }
+    inline const PointerOutput& getPointerOutput(void) const
+    { return pointerOutput; }
+
+    /**
+     * Replaces the eight/sixteen directions with a radial layout, or
+     * restores them if the layout is empty. Radial actions are kept only up
+     * to the new layout's action count.
+     */
+    void setLayout(const SectorLayout& newLayout);
+    inline const SectorLayout& getLayout(void) const
+    { return layout; }
+
     /**
      * Updates the tracker with the given values, and fires an action if
      * necessary.
      * @param x The x-axis' new position
      * @param y The y-axis' new position
      * @param pressed State of the joystick's button
+     * @param timestamp When the position was read, in steady_clock
+     * nanoseconds; if zero, one polling period after the last update
      */
-    void update(int x, int y, int pressed);
+    void update(int x, int y, int pressed, std::int64_t timestamp = 0);
 
     /**
      * Saves settings to the given settings object.
@@ -109,7 +154,11 @@ public:
             useSequencing == other.useSequencing &&
             useDiagonals == other.useDiagonals &&
             isButtonSticky == other.isButtonSticky &&
-            primaryAngle == other.primaryAngle;
+            primaryAngle == other.primaryAngle &&
+            conditioning == other.conditioning &&
+            gamepadOutput == other.gamepadOutput &&
+            pointerOutput == other.pointerOutput &&
+            layout == other.layout;
     }
 
     // "Not Equal" comparison overload, needed for Editing objects
@@ -118,27 +167,27 @@ public:
             useSequencing != other.useSequencing ||
             useDiagonals != other.useDiagonals ||
             isButtonSticky != other.isButtonSticky ||
-            primaryAngle != other.primaryAngle;
+            primaryAngle != other.primaryAngle ||
+            conditioning != other.conditioning ||
+            gamepadOutput != other.gamepadOutput ||
+            pointerOutput != other.pointerOutput ||
+            layout != other.layout;
     }
 
     JoystickTracker& operator=(const JoystickTracker& other) {
+        // Resizes the keys first, so copying them doesn't reallocate
+        setLayout(other.layout);
         *dynamic_cast<KeySender *>(this) = other;
         *dynamic_cast<Joystick *>(this) = other;
         useSequencing = other.useSequencing;
         useDiagonals = other.useDiagonals;
         isButtonSticky = other.isButtonSticky;
         primaryAngle = other.primaryAngle;
+        setConditioning(other.conditioning);
+        pointerOutput = other.pointerOutput;
         return *this;
     }
 
-    /**
-     * Gets the last position of the joystick.
-     * @return A pair of the x/y position
-     */
-    inline std::pair<int, int> getPosition(void) const {
-        return { lastX, lastY };
-    }
-
     /**
      * Dumps the joystick state to standard output.
      * @param id Character id to include in the dump (useful for identification)
@@ -146,10 +195,22 @@ public:
     //void dumpState(char id) const;
 
 private:
-    // The previous X and Y position, for tracking velocity.
-    int lastX = 0;
-    int lastY = 0;
     int lastPressed = 0;
+    std::int64_t lastTimestamp = 0;
+
+    InputConditioning conditioning;
+    StickFilter filter;
+    PointerOutput pointerOutput;
+    SectorLayout layout;
+    // The radial action held, or -1
+    int lastRadialAction = -1;
+
+    // The last classification: ring (0 none, 1 short, 2 far) and direction
+    // (see directionOf()), after and before conditioning
+    int lastRing = 0;
+    int lastDirection = 0;
+    int lastRawRing = 0;
+    int lastRawDirection = 0;
 
     // If true, vector sequencing is enabled.
     bool useSequencing = false;
@@ -164,6 +225,24 @@ private:
     bool stickyState = false;
     bool isEnabled = true;
 
+    /**
+     * Finds which threshold ring a distance from the center falls in.
+     * @param dist Distance from the center
+     * @param current The ring the stick was in, which the band favours
+     * @param band Hysteresis band, in axis units
+     * @return 0 inside the short threshold, 1 between thresholds, 2 beyond
+     * the far threshold
+     */
+    int ringOf(double dist, int current, int band) const;
+
+    /**
+     * Finds which of the eight directions an angle points in.
+     * @param angle Angle from atan2(), -pi to pi
+     * @return (horizontal + 1) * 3 + (vertical + 1), each of those being -1,
+     * 0 or 1
+     */
+    int directionOf(double angle) const;
+
     /**
      * Gets the index of an action to trigger, based on the axes' states.
      * @param hstate The horizontal axis' toState() value
@@ -182,6 +261,24 @@ private:
      * be fired.
      */
     int getActionBits(int hstate, int vstate) const;
+
+    /**
+     * Fires the stick button's action if the button changed.
+     */
+    void updateButton(int pressed);
+
+    /**
+     * Classifies a position with the radial layout and fires its sector's
+     * action. Uses lastRing (ring + 1) and lastDirection (sector).
+     * @param fx, fy The conditioned position
+     * @param x, y The raw position, for diagnostics
+     */
+    void updateRadial(double fx, double fy, int x, int y);
+
+    /**
+     * Releases every direction and radial action.
+     */
+    void releaseActions(void);
 };
 
 #endif // JOYSTICKTRACKER_H
@@ -0,0 +1,102 @@
+/**
+ * @file mpscqueue.h
+ * @brief Lock-free queue for handing small records to one consumer thread.
+ */
+#ifndef MPSCQUEUE_H
+#define MPSCQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+/**
+ * @class MpscQueue
+ * @brief A bounded, lock-free queue with any number of producers and a single
+ * consumer.
+ *
+ * Each cell carries a sequence number that says whose turn it is: producers
+ * claim a cell by advancing the tail with a compare-and-swap, fill it, then
+ * publish it by bumping its sequence. The consumer only reads cells whose
+ * sequence says they are full. Nothing is allocated after construction, and
+ * a full queue makes push() fail instead of blocking.
+ *
+ * Only one thread may call pop().
+ */
+template<typename T, std::size_t Capacity>
+class MpscQueue
+{
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+        "MpscQueue capacity must be a power of two");
+    static_assert(std::is_trivially_copyable<T>::value,
+        "MpscQueue records must be trivially copyable");
+
+public:
+    MpscQueue(void) {
+        for (std::size_t i = 0; i < Capacity; i++)
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    /**
+     * Adds a record. Safe from any thread.
+     * @param value The record to add
+     * @return False if the queue is full
+     */
+    bool push(const T& value) {
+        auto pos = tail.load(std::memory_order_relaxed);
+
+        for (;;) {
+            auto& cell = cells[pos & (Capacity - 1)];
+            auto seq = cell.sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+
+            if (diff == 0) {
+                // The cell is free; try to claim it
+                if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.value = value;
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                // The consumer hasn't emptied this cell yet
+                return false;
+            } else {
+                // Another producer claimed the cell first
+                pos = tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * Removes the oldest record. Must only be called from the consumer thread.
+     * @param value Where to put the record
+     * @return False if the queue is empty
+     */
+    bool pop(T& value) {
+        auto& cell = cells[head & (Capacity - 1)];
+        auto seq = cell.sequence.load(std::memory_order_acquire);
+        if (seq != head + 1)
+            return false;
+
+        value = cell.value;
+        cell.sequence.store(head + Capacity, std::memory_order_release);
+        head++;
+        return true;
+    }
+
+private:
+    struct Cell {
+        std::atomic<std::size_t> sequence;
+        T value;
+    };
+
+    Cell cells[Capacity];
+    // Kept apart so producers and the consumer don't share a cache line
+    alignas(64) std::atomic<std::size_t> tail {0};
+    alignas(64) std::size_t head = 0;
+};
+
+#endif // MPSCQUEUE_H
@@ -0,0 +1,85 @@
+#include "periodictimer.h"
+
+#include <thread>
+
+#ifndef PLA_WINDOWS
+#include <cerrno>
+#include <cstdint>
+#include <sys/timerfd.h>
+#include <unistd.h>
+#endif
+
+PeriodicTimer::PeriodicTimer(std::chrono::nanoseconds period) :
+    period(period)
+{
+#ifndef PLA_WINDOWS
+    fd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+#endif
+    start();
+}
+
+PeriodicTimer::~PeriodicTimer(void)
+{
+#ifndef PLA_WINDOWS
+    if (fd != -1)
+        ::close(fd);
+#endif
+}
+
+void PeriodicTimer::setPeriod(std::chrono::nanoseconds newPeriod)
+{
+    period = newPeriod;
+    start();
+}
+
+void PeriodicTimer::start(void)
+{
+#ifdef PLA_WINDOWS
+    next = std::chrono::steady_clock::now() + period;
+#else
+    if (fd == -1)
+        return;
+
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    auto ns = period.count();
+    itimerspec spec {};
+    spec.it_interval.tv_sec = ns / 1000000000;
+    spec.it_interval.tv_nsec = ns % 1000000000;
+
+    auto first = now.tv_sec * 1000000000ll + now.tv_nsec + ns;
+    spec.it_value.tv_sec = first / 1000000000;
+    spec.it_value.tv_nsec = first % 1000000000;
+    timerfd_settime(fd, TFD_TIMER_ABSTIME, &spec, nullptr);
+#endif
+}
+
+unsigned long PeriodicTimer::wait(void)
+{
+#ifdef PLA_WINDOWS
+    auto now = std::chrono::steady_clock::now();
+    unsigned long missed = 0;
+    if (now > next + period)
+        missed = static_cast<unsigned long>((now - next) / period);
+
+    next += period * missed;
+    std::this_thread::sleep_until(next);
+    next += period;
+    return missed;
+#else
+    if (fd == -1) {
+        // No timerfd; fall back to a relative sleep
+        std::this_thread::sleep_for(period);
+        return 0;
+    }
+
+    // Blocks until at least one deadline has passed; the count says how many
+    std::uint64_t expirations = 0;
+    while (::read(fd, &expirations, sizeof(expirations)) != sizeof(expirations)) {
+        if (errno != EINTR)
+            return 0;
+    }
+    return expirations > 1 ? static_cast<unsigned long>(expirations - 1) : 0;
+#endif
+}
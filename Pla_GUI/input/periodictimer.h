@@ -0,0 +1,60 @@
+/**
+ * @file periodictimer.h
+ * @brief Wakes a thread at a fixed rate, without drift.
+ */
+#ifndef PERIODICTIMER_H
+#define PERIODICTIMER_H
+
+#include <chrono>
+
+/**
+ * @class PeriodicTimer
+ * @brief Sleeps until absolute deadlines spaced one period apart.
+ *
+ * Deadlines are fixed when the timer is started, so the time spent between
+ * waits doesn't push the schedule back. On Linux this is a timerfd on
+ * CLOCK_MONOTONIC; elsewhere the thread sleeps until each deadline.
+ *
+ * If a deadline passes before wait() is called, the following wait returns
+ * straight away and reports how many deadlines were missed; the schedule is
+ * not shifted to catch up.
+ */
+class PeriodicTimer
+{
+public:
+    explicit PeriodicTimer(std::chrono::nanoseconds period);
+    ~PeriodicTimer(void);
+
+    PeriodicTimer(const PeriodicTimer&) = delete;
+    PeriodicTimer& operator=(const PeriodicTimer&) = delete;
+
+    /**
+     * Changes the period and restarts the schedule.
+     */
+    void setPeriod(std::chrono::nanoseconds newPeriod);
+
+    std::chrono::nanoseconds getPeriod(void) const
+    { return period; }
+
+    /**
+     * Makes the first deadline one period from now.
+     */
+    void start(void);
+
+    /**
+     * Sleeps until the next deadline.
+     * @return The number of deadlines that passed unserved since the last
+     * wait; zero if the caller kept up
+     */
+    unsigned long wait(void);
+
+private:
+    std::chrono::nanoseconds period;
+#ifdef PLA_WINDOWS
+    std::chrono::steady_clock::time_point next;
+#else
+    int fd;
+#endif
+};
+
+#endif // PERIODICTIMER_H
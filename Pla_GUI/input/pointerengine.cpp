@@ -0,0 +1,98 @@
+#include "pointerengine.h"
+
+#include "config.h"
+#include "controller.h"
+#include "keybackend.h"
+#include "scheduler.h"
+#include "trace.h"
+
+#include <chrono>
+
+std::atomic_bool PointerEngine::running (false);
+std::atomic<std::uint64_t> PointerEngine::task (0);
+std::int64_t PointerEngine::lastTick = 0;
+PointerEngine::Remainder PointerEngine::remainders[3] = {};
+
+static constexpr std::int64_t tickPeriod = 1000000000 / config::PointerRate;
+static constexpr std::int64_t idlePeriod =
+    std::chrono::duration_cast<std::chrono::nanoseconds>(config::PointerIdleCheck).count();
+
+void PointerEngine::start(void)
+{
+    if (running.exchange(true))
+        return;
+
+    lastTick = 0;
+    task.store(Scheduler::at(Scheduler::now(), tick));
+}
+
+void PointerEngine::stop(void)
+{
+    if (!running.exchange(false))
+        return;
+
+    // A tick already underway may schedule one more; cancel until none does
+    for (;;) {
+        auto current = task.load();
+        Scheduler::cancel(current);
+        if (task.load() == current)
+            break;
+    }
+}
+
+void PointerEngine::tick(std::int64_t deadline)
+{
+    if (!running.load())
+        return;
+
+    // Deadlines, not wake-up times, set the distance moved, so a late tick
+    // doesn't change the speed
+    auto dt = (lastTick != 0 ? deadline - lastTick : tickPeriod) / 1e9;
+
+    bool active = false;
+    if (Controller::connected() && Controller::isActive()) {
+        PLA_TRACE_SCOPE("input", "PointerEngine tick");
+        auto state = Controller::snapshot();
+        active |= drive(Controller::Left, state.leftX, state.leftY, remainders[0], dt);
+        active |= drive(Controller::Right, state.rightX, state.rightY, remainders[1], dt);
+        active |= drive(Controller::Primary.getPG(), state.primaryX, state.primaryY,
+            remainders[2], dt);
+    }
+
+    lastTick = active ? deadline : 0;
+    task.store(Scheduler::at(deadline + (active ? tickPeriod : idlePeriod), tick));
+}
+
+bool PointerEngine::drive(const JoystickTracker& stick, int x, int y, Remainder& left,
+    double dt)
+{
+    const auto& output = stick.getPointerOutput();
+    if (output.mode == PointerOutput::Keys || !stick.getEnabled()) {
+        left = {0, 0};
+        return false;
+    }
+
+    double vx, vy;
+    output.velocity(x, y, vx, vy);
+    if (vx == 0 && vy == 0) {
+        left = {0, 0};
+        return true;
+    }
+
+    // Send whole units, keeping the fraction for the next tick
+    left.x += vx * dt;
+    left.y += vy * dt;
+    auto dx = static_cast<int>(left.x);
+    auto dy = static_cast<int>(left.y);
+    left.x -= dx;
+    left.y -= dy;
+
+    if (dx != 0 || dy != 0) {
+        if (output.mode == PointerOutput::Pointer)
+            KeyBackend::current().movePointer(dx, -dy); // Screen y grows downwards
+        else
+            KeyBackend::current().scroll(dx, dy);
+    }
+
+    return true;
+}
@@ -0,0 +1,58 @@
+/**
+ * @file pointerengine.h
+ * @brief Moves the pointer and scroll wheel from sticks in pointer mode.
+ */
+#ifndef POINTERENGINE_H
+#define POINTERENGINE_H
+
+#include <atomic>
+#include <cstdint>
+
+class JoystickTracker;
+
+/**
+ * @class PointerEngine
+ * @brief Turns stick deflection into pointer motion on a fixed tick.
+ *
+ * Runs as a repeating Scheduler task at config::PointerRate, independent of
+ * the polling rate, reading the latest positions from Controller::snapshot().
+ * Motion is accumulated in fractions of a pixel (or scroll step), so slow
+ * movement is smooth and no distance is lost to rounding. While no stick is
+ * in pointer mode the task only checks back occasionally.
+ */
+class PointerEngine
+{
+public:
+    /**
+     * Starts ticking. The Scheduler must be running.
+     */
+    static void start(void);
+
+    /**
+     * Stops ticking, waiting for a tick in progress to finish.
+     */
+    static void stop(void);
+
+private:
+    // Distance not yet sent, per stick
+    struct Remainder {
+        double x;
+        double y;
+    };
+
+    static std::atomic_bool running;
+    static std::atomic<std::uint64_t> task;
+    static std::int64_t lastTick;
+    static Remainder remainders[3];
+
+    static void tick(std::int64_t deadline);
+
+    /**
+     * Moves the pointer for one stick.
+     * @return True if the stick is in pointer or scroll mode
+     */
+    static bool drive(const JoystickTracker& stick, int x, int y, Remainder& left,
+        double dt);
+};
+
+#endif // POINTERENGINE_H
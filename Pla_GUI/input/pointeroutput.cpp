@@ -0,0 +1,55 @@
+#include "pointeroutput.h"
+
+#include "config.h"
+
+#include <algorithm>
+#include <cmath>
+
+PointerOutput::PointerOutput(void) :
+    mode(Keys),
+    speed(config::PointerSpeed),
+    scrollSpeed(config::ScrollSpeed),
+    deadzone(config::PointerDeadzone),
+    acceleration(config::PointerAcceleration)
+{
+
+}
+
+void PointerOutput::velocity(int x, int y, double& vx, double& vy) const
+{
+    auto distance = std::hypot(x, y);
+    if (distance <= deadzone) {
+        vx = 0;
+        vy = 0;
+        return;
+    }
+
+    auto amount = std::min(1., (distance - deadzone) / (32767. - deadzone));
+    auto v = (mode == Scroll ? scrollSpeed : speed) * std::pow(amount, acceleration);
+    vx = v * x / distance;
+    vy = v * y / distance;
+}
+
+void PointerOutput::save(QSettings& settings) const
+{
+    settings.beginGroup("pointer");
+    settings.setValue("mode", static_cast<int>(mode));
+    settings.setValue("speed", speed);
+    settings.setValue("scrollspeed", scrollSpeed);
+    settings.setValue("deadzone", deadzone);
+    settings.setValue("acceleration", acceleration);
+    settings.endGroup();
+}
+
+void PointerOutput::load(QSettings& settings)
+{
+    settings.beginGroup("pointer");
+    auto m = settings.value("mode", Keys).toInt();
+    mode = m == Pointer || m == Scroll ? static_cast<Mode>(m) : Keys;
+    speed = settings.value("speed", config::PointerSpeed).toDouble();
+    scrollSpeed = settings.value("scrollspeed", config::ScrollSpeed).toDouble();
+    deadzone = settings.value("deadzone", config::PointerDeadzone).toInt();
+    deadzone = std::max(0, std::min(32766, deadzone));
+    acceleration = settings.value("acceleration", config::PointerAcceleration).toDouble();
+    settings.endGroup();
+}
@@ -0,0 +1,66 @@
+/**
+ * @file pointeroutput.h
+ * @brief Settings for driving the mouse pointer or scroll wheel with a stick.
+ */
+#ifndef POINTEROUTPUT_H
+#define POINTEROUTPUT_H
+
+#include <QSettings>
+
+/**
+ * @struct PointerOutput
+ * @brief Whether a stick fires keys or moves the pointer, and how fast.
+ * Saved with its profile.
+ *
+ * Speed follows deflection past the deadzone (0-1) raised to the
+ * acceleration exponent, so small movements stay precise while full
+ * deflection crosses the screen quickly.
+ */
+struct PointerOutput {
+    enum Mode {
+        Keys,     // The stick fires its actions as usual
+        Pointer,  // The stick moves the mouse pointer
+        Scroll    // The stick turns the scroll wheel
+    };
+
+    Mode mode;
+    /**
+     * Pointer speed at full deflection, in pixels per second.
+     */
+    double speed;
+    /**
+     * Scroll speed at full deflection, in wheel steps per second.
+     */
+    double scrollSpeed;
+    /**
+     * Distance from center (in axis units) that doesn't move anything.
+     */
+    int deadzone;
+    /**
+     * Acceleration exponent. 1 is linear; higher values slow the start of
+     * the stick's travel.
+     */
+    double acceleration;
+
+    PointerOutput(void);
+
+    /**
+     * Gets the velocity for a stick position, in pixels (or steps) per
+     * second. Positive y is up, as for the trackers.
+     */
+    void velocity(int x, int y, double& vx, double& vy) const;
+
+    void save(QSettings& settings) const;
+    void load(QSettings& settings);
+
+    bool operator==(const PointerOutput& other) const {
+        return mode == other.mode && speed == other.speed &&
+            scrollSpeed == other.scrollSpeed && deadzone == other.deadzone &&
+            acceleration == other.acceleration;
+    }
+    bool operator!=(const PointerOutput& other) const {
+        return !(*this == other);
+    }
+};
+
+#endif // POINTEROUTPUT_H
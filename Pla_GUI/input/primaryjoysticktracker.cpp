@@ -3,6 +3,17 @@
 PrimaryJoystickTracker::PrimaryJoystickTracker() :
     currentPG(0) {}
 
+PrimaryJoystickTracker::PrimaryJoystickTracker(const PrimaryJoystickTracker& other) :
+    groups(other.groups),
+    currentPG(other.currentPG.load()) {}
+
+PrimaryJoystickTracker& PrimaryJoystickTracker::operator=(const PrimaryJoystickTracker& other)
+{
+    groups = other.groups;
+    currentPG.store(other.currentPG.load());
+    return *this;
+}
+
 JoystickTracker& PrimaryJoystickTracker::getPG(int pg)
 {
     if (pg == -1)
@@ -17,6 +17,8 @@
 class PrimaryJoystickTracker {
 public:
     PrimaryJoystickTracker();
+    PrimaryJoystickTracker(const PrimaryJoystickTracker& other);
+    PrimaryJoystickTracker& operator=(const PrimaryJoystickTracker& other);
 
     void setPG(int pg);
     JoystickTracker& getPG(int pg = -1);
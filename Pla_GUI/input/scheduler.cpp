@@ -0,0 +1,132 @@
+#include "scheduler.h"
+
+#include "config.h"
+#include "latency.h"
+#include "threadpolicy.h"
+#include "trace.h"
+
+#include <chrono>
+
+std::mutex Scheduler::lock;
+std::condition_variable Scheduler::changed;
+std::multimap<std::int64_t, Scheduler::Entry> Scheduler::pending;
+std::unordered_map<std::uint64_t, std::int64_t> Scheduler::deadlines;
+std::uint64_t Scheduler::nextId = 1;
+std::uint64_t Scheduler::runningId = 0;
+bool Scheduler::running = false;
+std::thread Scheduler::thread;
+
+std::int64_t Scheduler::now(void)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Scheduler::start(bool realtime)
+{
+    std::lock_guard<std::mutex> guard (lock);
+    if (running)
+        return;
+
+    running = true;
+    thread = std::thread(run, realtime);
+}
+
+void Scheduler::stop(void)
+{
+    {
+        std::lock_guard<std::mutex> guard (lock);
+        if (!running)
+            return;
+        running = false;
+    }
+    changed.notify_all();
+    thread.join();
+
+    std::lock_guard<std::mutex> guard (lock);
+    pending.clear();
+    deadlines.clear();
+}
+
+std::uint64_t Scheduler::at(std::int64_t deadline, Task task)
+{
+    std::uint64_t id;
+    bool earliest;
+    {
+        std::lock_guard<std::mutex> guard (lock);
+        id = nextId++;
+        auto it = pending.emplace(deadline, Entry {id, std::move(task)});
+        deadlines.emplace(id, deadline);
+        earliest = it == pending.begin();
+    }
+
+    // Only a new earliest deadline changes how long the thread sleeps
+    if (earliest)
+        changed.notify_all();
+    return id;
+}
+
+void Scheduler::cancel(std::uint64_t id)
+{
+    if (id == 0)
+        return;
+
+    std::unique_lock<std::mutex> guard (lock);
+
+    auto found = deadlines.find(id);
+    if (found != deadlines.end()) {
+        auto range = pending.equal_range(found->second);
+        for (auto it = range.first; it != range.second; ++it) {
+            if (it->second.id == id) {
+                pending.erase(it);
+                break;
+            }
+        }
+        deadlines.erase(found);
+        return;
+    }
+
+    // Already taken off the queue; if it is still running, wait unless it
+    // is cancelling itself
+    if (runningId == id && std::this_thread::get_id() != thread.get_id())
+        changed.wait(guard, [id] { return runningId != id; });
+}
+
+void Scheduler::run(bool realtime)
+{
+    Trace::setThreadName("scheduler");
+    if (realtime)
+        ThreadPolicy::setRealtime(config::RealtimePriority);
+
+    std::unique_lock<std::mutex> guard (lock);
+    while (running) {
+        if (pending.empty()) {
+            changed.wait(guard);
+            continue;
+        }
+
+        auto deadline = pending.begin()->first;
+        auto current = now();
+        if (current < deadline) {
+            changed.wait_until(guard, std::chrono::steady_clock::time_point(
+                std::chrono::nanoseconds(deadline)));
+            continue;
+        }
+
+        auto entry = std::move(pending.begin()->second);
+        pending.erase(pending.begin());
+        deadlines.erase(entry.id);
+        runningId = entry.id;
+
+        guard.unlock();
+        Latency::recordTimerLateness(current - deadline);
+        {
+            PLA_TRACE_SCOPE("scheduler", "Scheduler task");
+            entry.task(deadline);
+        }
+        guard.lock();
+
+        runningId = 0;
+        changed.notify_all();
+    }
+}
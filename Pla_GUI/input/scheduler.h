@@ -0,0 +1,83 @@
+/**
+ * @file scheduler.h
+ * @brief Runs timed key events independently of the polling loop.
+ */
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+/**
+ * @class Scheduler
+ * @brief One shared thread that runs tasks at absolute deadlines.
+ *
+ * Used for anything that has to happen at a precise time rather than on the
+ * next input frame: pulse-width steering, turbo, hold timeouts. The thread
+ * sleeps until the earliest deadline, so it costs nothing while idle. How
+ * late each task runs is recorded as Latency::TimerLateness.
+ *
+ * Tasks run on the scheduler thread, one at a time, and may schedule further
+ * tasks. Times are std::chrono::steady_clock nanoseconds.
+ */
+class Scheduler
+{
+public:
+    using Task = std::function<void(std::int64_t deadline)>;
+
+    /**
+     * Starts the scheduler thread.
+     * @param realtime If true, ask for real-time priority for the thread
+     */
+    static void start(bool realtime = false);
+
+    /**
+     * Stops the thread. Tasks still pending are dropped.
+     */
+    static void stop(void);
+
+    /**
+     * Runs a task at the given time (or as soon as possible, if it has
+     * passed). Tasks scheduled before start() wait for it.
+     * @param deadline When to run the task
+     * @param task The task; receives its deadline
+     * @return An ID for cancel()
+     */
+    static std::uint64_t at(std::int64_t deadline, Task task);
+
+    /**
+     * Cancels a pending task. If the task is running on another thread, waits
+     * for it to finish.
+     * @param id The ID from at(); 0 and IDs no longer pending are ignored
+     */
+    static void cancel(std::uint64_t id);
+
+    /**
+     * Gets the current time on the scheduler's clock.
+     */
+    static std::int64_t now(void);
+
+private:
+    struct Entry {
+        std::uint64_t id;
+        Task task;
+    };
+
+    static std::mutex lock;
+    static std::condition_variable changed;
+    static std::multimap<std::int64_t, Entry> pending;
+    static std::unordered_map<std::uint64_t, std::int64_t> deadlines;
+    static std::uint64_t nextId;
+    static std::uint64_t runningId;
+    static bool running;
+    static std::thread thread;
+
+    static void run(bool realtime);
+};
+
+#endif // SCHEDULER_H
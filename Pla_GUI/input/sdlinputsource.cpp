@@ -0,0 +1,47 @@
+#include "sdlinputsource.h"
+
+#include "latency.h"
+
+SdlInputSource::SdlInputSource(const std::atomic<SDL_Joystick *>& joystick,
+    const std::atomic_int& pg, std::chrono::nanoseconds period) :
+    joystick(joystick),
+    pg(pg),
+    timer(period)
+{
+
+}
+
+bool SdlInputSource::read(InputFrame& frame)
+{
+    auto js = joystick.load();
+    if (js == nullptr) {
+        // Read immediately after reconnecting
+        restart = true;
+        return false;
+    }
+
+    // Keep a steady period, no matter how long the last frame took
+    if (restart) {
+        timer.start();
+        restart = false;
+    } else {
+        auto missed = timer.wait();
+        if (missed != 0)
+            Latency::addMissedDeadlines(missed);
+    }
+
+    SDL_JoystickUpdate();
+
+    frame.timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    for (int i = 0; i < InputFrame::AxisCount; i++)
+        frame.axes[i] = SDL_JoystickGetAxis(js, i);
+    frame.buttons = 0;
+    for (int i = 0; i < InputFrame::ButtonCount; i++) {
+        if (SDL_JoystickGetButton(js, i))
+            frame.buttons |= 1u << i;
+    }
+    frame.pg = static_cast<std::uint8_t>(pg.load());
+
+    return true;
+}
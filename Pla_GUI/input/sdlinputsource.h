@@ -0,0 +1,40 @@
+/**
+ * @file sdlinputsource.h
+ * @brief Reads input frames from the controller through SDL.
+ */
+#ifndef SDLINPUTSOURCE_H
+#define SDLINPUTSOURCE_H
+
+#include "inputsource.h"
+#include "periodictimer.h"
+
+#include <SDL2/SDL.h>
+#include <atomic>
+#include <chrono>
+
+/**
+ * @class SdlInputSource
+ * @brief Polls an SDL joystick at a fixed rate, on absolute deadlines.
+ */
+class SdlInputSource : public InputSource
+{
+public:
+    /**
+     * @param joystick The joystick to poll; may be changed or cleared while
+     * the source is in use
+     * @param pg The currently selected PG, recorded in each frame
+     * @param period Time between polls
+     */
+    SdlInputSource(const std::atomic<SDL_Joystick *>& joystick,
+        const std::atomic_int& pg, std::chrono::nanoseconds period);
+
+    bool read(InputFrame& frame) override;
+
+private:
+    const std::atomic<SDL_Joystick *>& joystick;
+    const std::atomic_int& pg;
+    PeriodicTimer timer;
+    bool restart = true;
+};
+
+#endif // SDLINPUTSOURCE_H
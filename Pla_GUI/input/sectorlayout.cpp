@@ -0,0 +1,202 @@
+#include "sectorlayout.h"
+
+#include "config.h"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+constexpr int SectorLayout::MaxRings;
+constexpr int SectorLayout::MinSectors;
+constexpr int SectorLayout::MaxSectors;
+const int SectorLayout::MinRadius = 2 * config::StickRadialHysteresis;
+constexpr int SectorLayout::Bins;
+
+static constexpr double TwoPi = 6.283185307179586;
+
+/**
+ * Gets a value from 0 to 4 that rises with atan2(b, a), without calling it.
+ */
+static inline double diamond(double a, double b)
+{
+    if (b >= 0)
+        return a >= 0 ? b / (a + b) : 1 - a / (b - a);
+    return a < 0 ? 2 - b / (-a - b) : 3 + a / (a - b);
+}
+
+/**
+ * Gets the diamond angle of a direction given in radians clockwise from up.
+ */
+static inline double diamondOf(double angle)
+{
+    angle = std::fmod(angle, TwoPi);
+    if (angle < 0)
+        angle += TwoPi;
+    return diamond(std::cos(angle), std::sin(angle));
+}
+
+/**
+ * Tests if a diamond angle is within [from, to), wrapping past 4.
+ */
+static inline bool inArc(double value, double from, double to)
+{
+    return from <= to ? value >= from && value < to : value >= from || value < to;
+}
+
+SectorLayout::SectorLayout(void) :
+    rings(),
+    firstAction(),
+    tables(),
+    count(0),
+    actions(0),
+    angleBand(0)
+{
+
+}
+
+bool SectorLayout::addRing(Ring ring)
+{
+    if (count >= MaxRings)
+        return false;
+
+    ring.sectors = std::max(MinSectors, std::min(MaxSectors, ring.sectors));
+    ring.radius = std::max(MinRadius, ring.radius);
+    rings[count++] = ring;
+    std::sort(rings.begin(), rings.begin() + count,
+        [](const Ring& a, const Ring& b) { return a.radius < b.radius; });
+
+    actions = 0;
+    for (int i = 0; i < count; i++) {
+        firstAction[i] = actions;
+        actions += rings[i].sectors;
+        build(i);
+    }
+
+    return true;
+}
+
+void SectorLayout::clear(void)
+{
+    count = 0;
+    actions = 0;
+}
+
+void SectorLayout::setBand(double radians)
+{
+    angleBand = std::max(0., radians);
+    for (int i = 0; i < count; i++)
+        build(i);
+}
+
+void SectorLayout::build(int ringIndex)
+{
+    const auto& r = rings[ringIndex];
+    auto& table = tables[ringIndex];
+    auto width = TwoPi / r.sectors;
+    auto b = std::min(angleBand, width * 0.45);
+
+    // Where each sector starts
+    std::array<double, MaxSectors> starts;
+    for (int k = 0; k < r.sectors; k++) {
+        auto angle = r.angle + (k - 0.5) * width;
+        starts[k] = diamondOf(angle);
+        table.stayFrom[k] = static_cast<float>(diamondOf(angle - b));
+        table.stayTo[k] = static_cast<float>(diamondOf(angle + width + b));
+    }
+
+    // The narrowest sector is wider than a bin, so at most one boundary
+    // falls in each bin
+    constexpr double binWidth = 4. / Bins;
+    for (int j = 0; j < Bins; j++) {
+        auto from = j * binWidth;
+        int sector = 0;
+        for (int k = 0; k < r.sectors; k++) {
+            if (inArc(from, starts[k], starts[(k + 1) % r.sectors])) {
+                sector = k;
+                break;
+            }
+        }
+
+        auto next = starts[(sector + 1) % r.sectors];
+        table.sector[j] = static_cast<std::uint8_t>(sector);
+        table.split[j] = next > from && next < from + binWidth ?
+            static_cast<float>(next) : 5.f;
+    }
+}
+
+int SectorLayout::ringOf(double dist, int current, int band) const
+{
+    // No sector can be found for the center itself, however wide the band
+    if (dist <= 0)
+        return -1;
+
+    // Rings the stick is already past are easier to stay in
+    for (int i = count - 1; i >= 0; i--) {
+        if (dist >= rings[i].radius + (current >= i ? -band : band))
+            return i;
+    }
+
+    return -1;
+}
+
+int SectorLayout::sectorOf(int ringIndex, double x, double y, int current) const
+{
+    const auto& table = tables[ringIndex];
+    auto value = diamond(y, x);
+
+    if (current >= 0 && current < rings[ringIndex].sectors &&
+            inArc(value, table.stayFrom[current], table.stayTo[current]))
+        return current;
+
+    auto bin = std::min(Bins - 1, static_cast<int>(value * (Bins / 4)));
+    int sector = table.sector[bin];
+    if (value >= table.split[bin])
+        sector = (sector + 1) % rings[ringIndex].sectors;
+    return sector;
+}
+
+void SectorLayout::save(QSettings& settings) const
+{
+    settings.beginGroup("layout");
+    settings.setValue("rings", count);
+    for (int i = 0; i < count; i++) {
+        settings.beginGroup(QString::fromStdString("ring" + std::to_string(i)));
+        settings.setValue("sectors", rings[i].sectors);
+        settings.setValue("angle", rings[i].angle);
+        settings.setValue("radius", rings[i].radius);
+        settings.endGroup();
+    }
+    settings.endGroup();
+}
+
+void SectorLayout::load(QSettings& settings)
+{
+    clear();
+
+    settings.beginGroup("layout");
+    auto rings = std::min(MaxRings, settings.value("rings", 0).toInt());
+    for (int i = 0; i < rings; i++) {
+        settings.beginGroup(QString::fromStdString("ring" + std::to_string(i)));
+        Ring ring;
+        ring.sectors = settings.value("sectors", 8).toInt();
+        ring.angle = settings.value("angle", 0.0).toDouble();
+        ring.radius = settings.value("radius",
+            config::JoystickDefaultShortThreshold).toInt();
+        addRing(ring);
+        settings.endGroup();
+    }
+    settings.endGroup();
+}
+
+bool SectorLayout::operator==(const SectorLayout& other) const
+{
+    if (count != other.count)
+        return false;
+
+    for (int i = 0; i < count; i++) {
+        if (!(rings[i] == other.rings[i]))
+            return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,146 @@
+/**
+ * @file sectorlayout.h
+ * @brief Divides a stick's range into rings of equal sectors, like a radial
+ * menu.
+ */
+#ifndef SECTORLAYOUT_H
+#define SECTORLAYOUT_H
+
+#include <QSettings>
+
+#include <array>
+#include <cstdint>
+
+/**
+ * @class SectorLayout
+ * @brief Up to three concentric rings, each split into 4 to 32 sectors.
+ *
+ * Sector 0 of each ring is centered on that ring's angle, measured clockwise
+ * from up; the rest follow clockwise. Actions are numbered through the rings
+ * from the innermost, so ring 1's first sector follows ring 0's last.
+ *
+ * Lookup never calls a trigonometric function. A position is reduced to its
+ * "diamond angle" (a cheap value, 0-4, that grows with the true angle), and
+ * a table of diamond-angle bins gives the sector directly; at most one
+ * boundary falls in a bin, so one comparison finishes the lookup. The cost
+ * is the same for 4 sectors or 96.
+ */
+class SectorLayout
+{
+public:
+    static constexpr int MaxRings = 3;
+    static constexpr int MinSectors = 4;
+    static constexpr int MaxSectors = 32;
+    // Smallest ring radius, in axis units; the center has no direction, so
+    // a ring must start clear of it, and of the default radial band
+    static const int MinRadius;
+
+    struct Ring {
+        // Number of sectors, MinSectors-MaxSectors
+        int sectors;
+        // Direction of sector 0's center, in radians clockwise from up
+        double angle;
+        // Distance from the center (in axis units) where the ring starts
+        int radius;
+
+        bool operator==(const Ring& other) const {
+            return sectors == other.sectors && angle == other.angle &&
+                radius == other.radius;
+        }
+    };
+
+    /**
+     * Creates an empty layout (no rings).
+     */
+    SectorLayout(void);
+
+    /**
+     * Adds a ring. Rings are kept sorted by radius; sector counts outside
+     * MinSectors-MaxSectors and radii under MinRadius are clamped.
+     * @return False if there are already MaxRings rings
+     */
+    bool addRing(Ring ring);
+
+    /**
+     * Removes every ring.
+     */
+    void clear(void);
+
+    inline bool isEmpty(void) const
+    { return count == 0; }
+    inline int ringCount(void) const
+    { return count; }
+    inline const Ring& ring(int index) const
+    { return rings[index]; }
+
+    /**
+     * Gets the total number of sectors, and so of actions.
+     */
+    inline int actionCount(void) const
+    { return actions; }
+
+    /**
+     * Gets the action for a ring's sector.
+     */
+    inline int actionIndex(int ringIndex, int sector) const
+    { return firstAction[ringIndex] + sector; }
+
+    /**
+     * Sets how far (in radians) the stick must move past a sector boundary
+     * before the sector changes. Limited to a little under half a sector.
+     */
+    void setBand(double radians);
+
+    /**
+     * Finds which ring a distance from the center falls in.
+     * @param dist Distance from the center
+     * @param current The ring the stick was in (-1 for none), which the band
+     * favours
+     * @param band Hysteresis band, in axis units
+     * @return The ring, or -1 inside the innermost ring or at the center
+     */
+    int ringOf(double dist, int current, int band) const;
+
+    /**
+     * Finds which sector of a ring a position falls in.
+     * @param ringIndex The ring, from ringOf()
+     * @param x The x-axis position (positive is right); not both zero
+     * @param y The y-axis position (positive is up)
+     * @param current The sector the stick was in on this ring, or -1; it is
+     * kept while within the band set by setBand()
+     */
+    int sectorOf(int ringIndex, double x, double y, int current) const;
+
+    void save(QSettings& settings) const;
+    void load(QSettings& settings);
+
+    bool operator==(const SectorLayout& other) const;
+    bool operator!=(const SectorLayout& other) const {
+        return !(*this == other);
+    }
+
+private:
+    static constexpr int Bins = 256;
+
+    // Lookup tables for one ring, all in diamond angles
+    struct Table {
+        // Sector at the start of each bin
+        std::array<std::uint8_t, Bins> sector;
+        // Where the next sector starts within the bin (above 4 if it doesn't)
+        std::array<float, Bins> split;
+        // Each sector's extent widened by the band, for hysteresis
+        std::array<float, MaxSectors> stayFrom;
+        std::array<float, MaxSectors> stayTo;
+    };
+
+    std::array<Ring, MaxRings> rings;
+    std::array<int, MaxRings> firstAction;
+    std::array<Table, MaxRings> tables;
+    int count;
+    int actions;
+    double angleBand;
+
+    void build(int ringIndex);
+};
+
+#endif // SECTORLAYOUT_H
@@ -0,0 +1,98 @@
+/**
+ * @file seqlock.h
+ * @brief Lock-free publication of small, frequently updated records.
+ */
+#ifndef SEQLOCK_H
+#define SEQLOCK_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+
+/**
+ * @class Seqlock
+ * @brief Lets one writer publish a record that any number of readers can copy
+ * out consistently, without locks.
+ *
+ * The writer bumps a sequence number to an odd value, writes, then bumps it
+ * to an even value. Readers retry if the sequence was odd or changed while
+ * they were copying. The record is stored as atomic words, so concurrent
+ * reads and writes are well-defined.
+ *
+ * Only one thread may call store().
+ */
+template<typename T>
+class Seqlock
+{
+    static_assert(std::is_trivially_copyable<T>::value,
+        "Seqlock records must be trivially copyable");
+
+public:
+    Seqlock(void) {
+        for (auto& w : words)
+            w.store(0, std::memory_order_relaxed);
+    }
+
+    /**
+     * Publishes a new record. Must only be called from the writer thread.
+     * @param value The record to publish
+     */
+    void store(const T& value) {
+        std::uint32_t buffer[WordCount] = {};
+        std::memcpy(buffer, &value, sizeof(T));
+
+        auto seq = sequence.load(std::memory_order_relaxed);
+        sequence.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        for (unsigned int i = 0; i < WordCount; i++)
+            words[i].store(buffer[i], std::memory_order_relaxed);
+
+        sequence.store(seq + 2, std::memory_order_release);
+    }
+
+    /**
+     * Copies out the latest complete record. Safe from any thread.
+     */
+    T load(void) const {
+        std::uint32_t buffer[WordCount];
+
+        for (;;) {
+            auto before = sequence.load(std::memory_order_acquire);
+            if (before & 1) {
+                // A write is in progress
+                std::this_thread::yield();
+                continue;
+            }
+
+            for (unsigned int i = 0; i < WordCount; i++)
+                buffer[i] = words[i].load(std::memory_order_relaxed);
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence.load(std::memory_order_relaxed) == before)
+                break;
+        }
+
+        T value;
+        std::memcpy(&value, buffer, sizeof(T));
+        return value;
+    }
+
+    /**
+     * Gets the number of records published so far.
+     */
+    std::uint32_t version(void) const {
+        return sequence.load(std::memory_order_acquire) / 2;
+    }
+
+private:
+    static constexpr unsigned int WordCount =
+        (sizeof(T) + sizeof(std::uint32_t) - 1) / sizeof(std::uint32_t);
+
+    std::atomic<std::uint32_t> sequence {0};
+    std::atomic<std::uint32_t> words[WordCount];
+};
+
+#endif // SEQLOCK_H
@@ -1,29 +1,87 @@
 #include "steeringtracker.h"
 
+#include "config.h"
+#include "latency.h"
+#include "scheduler.h"
+
+#include <algorithm>
+#include <cmath>
+
 SteeringTracker::SteeringTracker(bool d) :
     KeySender(2),
-    digital(d)
+    mode(d ? Digital : Analog),
+    pulsePeriod(config::SteeringPulsePeriod),
+    pulseCurve(config::SteeringPulseCurve),
+    duty(0),
+    side(0),
+    pulsing(false),
+    pulseTask(0),
+    releaseTask(0)
 {
 
 }
 
-void SteeringTracker::setDigital(bool v)
+SteeringTracker::SteeringTracker(const SteeringTracker& other) :
+    Joystick(other),
+    KeySender(other),
+    mode(other.mode),
+    isEnabled(other.isEnabled),
+    pulsePeriod(other.pulsePeriod),
+    pulseCurve(other.pulseCurve),
+    duty(0),
+    side(0),
+    pulsing(false),
+    pulseTask(0),
+    releaseTask(0)
+{
+
+}
+
+SteeringTracker& SteeringTracker::operator=(const SteeringTracker& other)
+{
+    // Settings only; pulsing state stays with this tracker
+    Joystick::operator=(other);
+    KeySender::operator=(other);
+    setMode(other.mode);
+    isEnabled = other.isEnabled;
+    pulsePeriod = other.pulsePeriod;
+    pulseCurve = other.pulseCurve;
+    return *this;
+}
+
+SteeringTracker::~SteeringTracker(void)
 {
-    digital = v;
+    stopPulsing();
 }
 
+void SteeringTracker::setDigital(bool v)
+{
+    setMode(v ? Digital : Analog);
+}
 
 bool SteeringTracker::getDigital(void) const
 {
-    return digital;
+    return mode == Digital;
+}
+
+void SteeringTracker::setMode(Mode m)
+{
+    // A running pulse train stops itself on its next period
+    if (m != Proportional)
+        duty.store(0);
+    mode = m;
 }
 
 void SteeringTracker::update(int pos) {
-    lastPosition = pos;
+    if (mode == Proportional) {
+        updateProportional(isEnabled ? pos : 0);
+        return;
+    }
 
-    if (!digital || !isEnabled)
+    if (mode != Digital || !isEnabled)
         return;
 
+    Latency::mark(Latency::Classify);
     if (pos > shortThreshold * 1.025) {
         sendKey(1, true); // right
     } else if (pos < -shortThreshold * 1.025) {
@@ -34,16 +92,109 @@ void SteeringTracker::update(int pos) {
     }
 }
 
+void SteeringTracker::updateProportional(int pos)
+{
+    // Position between the thresholds, 0-1
+    double amount;
+    auto span = farThreshold - shortThreshold;
+    if (span > 0)
+        amount = (std::abs(pos) - shortThreshold) / static_cast<double>(span);
+    else
+        amount = std::abs(pos) >= shortThreshold ? 1 : 0;
+    amount = std::max(0., std::min(1., amount));
+
+    auto newDuty = amount > 0 ? static_cast<float>(std::pow(amount, pulseCurve)) : 0.f;
+    side.store(pos < 0 ? 0 : 1);
+    duty.store(newDuty);
+    Latency::mark(Latency::Classify);
+
+    if (newDuty > 0) {
+        if (!pulsing.exchange(true))
+            pulseTask.store(Scheduler::at(Scheduler::now(), [this](std::int64_t t) { pulse(t); }));
+    } else {
+        // Let go now rather than at the end of the period
+        sendKey(0, false);
+        sendKey(1, false);
+    }
+}
+
+void SteeringTracker::pulse(std::int64_t start)
+{
+    auto d = duty.load();
+    auto s = side.load();
+    if (d <= 0) {
+        sendKey(0, false);
+        sendKey(1, false);
+        pulsing.store(false);
+        return;
+    }
+
+    auto period = std::chrono::duration_cast<std::chrono::nanoseconds>(pulsePeriod).count();
+    auto minimum = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        config::MinimumKeyPulse).count();
+    auto on = std::max(minimum, static_cast<std::int64_t>(d * period));
+
+    sendKey(1 - s, false);
+    sendKey(s, true);
+
+    // Hold through the period if the gap would be too short to register
+    if (period - on >= minimum) {
+        releaseTask.store(Scheduler::at(start + on,
+            [this, s](std::int64_t) { sendKey(s, false); }));
+    }
+
+    pulseTask.store(Scheduler::at(start + period, [this](std::int64_t t) { pulse(t); }));
+}
+
+void SteeringTracker::stopPulsing(void)
+{
+    if (!pulsing.load())
+        return;
+
+    // With the duty at zero, a period already underway won't schedule
+    // another; cancel until no new one appears
+    duty.store(0);
+    for (;;) {
+        auto task = pulseTask.load();
+        if (task != 0)
+            Scheduler::cancel(task);
+        if (pulseTask.load() == task)
+            break;
+    }
+
+    // No release is scheduled if every pulse so far held through its period
+    auto release = releaseTask.load();
+    if (release != 0)
+        Scheduler::cancel(release);
+    pulsing.store(false);
+}
+
 void SteeringTracker::save(QSettings &settings) const
 {
-    settings.setValue("digital", digital);
+    settings.setValue("digital", mode == Digital);
+    settings.setValue("mode", static_cast<int>(mode));
+    settings.setValue("pulseperiod", static_cast<int>(pulsePeriod.count()));
+    settings.setValue("pulsecurve", pulseCurve);
     KeySender::save(settings);
     saveThresholds(settings);
+    gamepadOutput.save(settings);
+}
+
+void SteeringTracker::setPulsePeriod(std::chrono::milliseconds period)
+{
+    pulsePeriod = std::max(config::SteeringMinPulsePeriod,
+        std::min(config::SteeringMaxPulsePeriod, period));
 }
 
 void SteeringTracker::load(QSettings &settings)
 {
-    digital = settings.value("digital", false).toBool();
+    // Profiles from before proportional mode only have "digital"
+    auto digital = settings.value("digital", false).toBool();
+    setMode(static_cast<Mode>(settings.value("mode", digital ? Digital : Analog).toInt()));
+    setPulsePeriod(std::chrono::milliseconds(settings.value("pulseperiod",
+        static_cast<int>(config::SteeringPulsePeriod.count())).toInt()));
+    pulseCurve = settings.value("pulsecurve", config::SteeringPulseCurve).toDouble();
     KeySender::load(settings);
     loadThresholds(settings);
+    gamepadOutput.load(settings);
 }
@@ -8,19 +8,37 @@
 #include "joystick.h"
 #include "keysender.h"
 
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
 /**
  * @class SteeringTracker
  * @brief Tracks steering wheel movement, firing actions when necesasary.
+ *
+ * In proportional mode the wheel's angle sets the duty cycle of its key: the
+ * key is pressed at the start of every period and released after a time
+ * that grows with the angle. Inside the short threshold nothing is pressed;
+ * past the far threshold the key is held. Pulses are timed by the Scheduler,
+ * not the polling loop.
  */
 class SteeringTracker : public Joystick, public KeySender
 {
 public:
+    enum Mode {
+        Analog,       // No keys; the game reads the axis
+        Digital,      // Left/right held past the short threshold
+        Proportional  // Left/right pulsed with a duty cycle set by the angle
+    };
+
     /**
      * Creates a tracker with the given digital/analog state.
      * @param d True for digital mode, false for analog
      */
     SteeringTracker(bool d = false);
-    virtual ~SteeringTracker(void) = default;
+    SteeringTracker(const SteeringTracker& other);
+    SteeringTracker& operator=(const SteeringTracker& other);
+    virtual ~SteeringTracker(void);
 
     /**
      * Enables/disables digital steering.
@@ -33,14 +51,38 @@ public:
      */
     bool getDigital(void) const;
 
+    void setMode(Mode m);
+    inline Mode getMode(void) const
+    { return mode; }
+
+    /**
+     * Sets the proportional mode's pulse period, limited to
+     * config::SteeringMinPulsePeriod-config::SteeringMaxPulsePeriod.
+     */
+    void setPulsePeriod(std::chrono::milliseconds period);
+    inline std::chrono::milliseconds getPulsePeriod(void) const
+    { return pulsePeriod; }
+
+    /**
+     * Sets the proportional mode's response curve: the duty cycle is the
+     * wheel's position between the thresholds (0-1) raised to this power.
+     * 1 is linear; higher values give finer control near the center.
+     */
+    inline void setPulseCurve(double exponent) {
+        pulseCurve = exponent;
+    }
+    inline double getPulseCurve(void) const
+    { return pulseCurve; }
+
     inline void setEnabled(bool yes) {
         isEnabled = yes;
     }
 
     /**
      * Fires actions based on the wheel's position.
-     * Analog steering requires no updates, so in analog mode this function will
-     * do nothing.
+     * Analog steering sends no keys, so in analog mode this function will do
+     * nothing; the wheel reaches games through the virtual gamepad instead
+     * (see GamepadOutput).
      * @param pos The wheel's position
      */
     void update(int pos);
@@ -59,27 +101,44 @@ public:
 
     // "Equal" comparison overload, needed for Editing objects
     bool operator==(const SteeringTracker& other) {
-        return KeySender::operator==(other) && digital == other.digital;
+        return KeySender::operator==(other) && mode == other.mode &&
+            pulsePeriod == other.pulsePeriod && pulseCurve == other.pulseCurve &&
+            gamepadOutput == other.gamepadOutput;
     }
 
     // "Not Equal" comparison overload, needed for Editing objects
     bool operator!=(const SteeringTracker& other) {
-        return KeySender::operator!=(other) || digital != other.digital;
+        return !(*this == other);
     }
 
+private:
+    Mode mode = Digital;
+    bool isEnabled = true;
+
+    std::chrono::milliseconds pulsePeriod;
+    double pulseCurve;
+
+    // Proportional mode state, shared with the Scheduler thread.
+    // duty is 0-1; side is the key being pulsed (0 left, 1 right).
+    std::atomic<float> duty;
+    std::atomic_int side;
+    // Set while a pulse period is scheduled
+    std::atomic_bool pulsing;
+    std::atomic<std::uint64_t> pulseTask;
+    std::atomic<std::uint64_t> releaseTask;
+
     /**
-     * Gets the last recorded position of the steering wheel.
+     * Works out the duty cycle for a position, and starts pulsing if needed.
      */
-    inline int getPosition(void) const {
-        return lastPosition;
-    }
+    void updateProportional(int pos);
 
-private:
-    // When true, digital steering is enabled.
-    bool digital = true;
-    bool isEnabled = true;
+    /**
+     * Starts one pulse period: presses the key, and schedules its release
+     * and the next period. Runs on the Scheduler thread.
+     */
+    void pulse(std::int64_t start);
 
-    int lastPosition = 0;
+    void stopPulsing(void);
 };
 
 
@@ -0,0 +1,51 @@
+#include "threadpolicy.h"
+
+#include "config.h"
+
+#ifdef PLA_WINDOWS
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+bool ThreadPolicy::setRealtime(int priority)
+{
+#ifdef PLA_WINDOWS
+    (void)priority;
+    return SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL) != 0;
+#else
+    sched_param param {};
+    param.sched_priority = priority;
+    if (pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) == 0)
+        return true;
+
+    // Unprivileged; a negative nice value may still be allowed (RLIMIT_NICE).
+    // On Linux, nice applies per thread when given the thread's ID.
+    auto tid = static_cast<id_t>(syscall(SYS_gettid));
+    return setpriority(PRIO_PROCESS, tid, config::HighPriorityNice) == 0;
+#endif
+}
+
+bool ThreadPolicy::pinToCpu(int cpu)
+{
+    if (cpu < 0)
+        return false;
+
+#ifdef PLA_WINDOWS
+    if (cpu >= static_cast<int>(sizeof(DWORD_PTR) * 8))
+        return false;
+    return SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << cpu) != 0;
+#else
+    if (cpu >= CPU_SETSIZE)
+        return false;
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#endif
+}
@@ -0,0 +1,34 @@
+/**
+ * @file threadpolicy.h
+ * @brief Scheduling settings for latency-sensitive threads.
+ */
+#ifndef THREADPOLICY_H
+#define THREADPOLICY_H
+
+/**
+ * @class ThreadPolicy
+ * @brief Raises the calling thread's priority or pins it to a CPU.
+ *
+ * Each call affects only the thread that makes it. Failures (usually missing
+ * privileges) are reported through the return value and otherwise harmless.
+ */
+class ThreadPolicy
+{
+public:
+    /**
+     * Asks for real-time scheduling (SCHED_FIFO on Linux, time-critical
+     * priority on Windows). If that is refused, tries a high nice priority.
+     * @param priority The SCHED_FIFO priority, 1-99
+     * @return True if either was granted
+     */
+    static bool setRealtime(int priority);
+
+    /**
+     * Runs the calling thread only on the given CPU.
+     * @param cpu Zero-based CPU number
+     * @return True if success
+     */
+    static bool pinToCpu(int cpu);
+};
+
+#endif // THREADPOLICY_H
@@ -0,0 +1,102 @@
+#include "virtualgamepad.h"
+
+#include "trace.h"
+
+#include <cstring>
+
+#include <fcntl.h>
+#include <linux/uinput.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+// Event code for each VirtualGamepad::Axis
+static const std::uint16_t axisCodes[VirtualGamepad::AxisCount] = {
+    ABS_X, ABS_Y, ABS_RX, ABS_RY, ABS_Z, ABS_RZ, ABS_WHEEL
+};
+
+VirtualGamepad::~VirtualGamepad(void)
+{
+    close();
+}
+
+bool VirtualGamepad::open(void)
+{
+    if (deviceFd != -1)
+        return true;
+
+    deviceFd = ::open("/dev/uinput", O_WRONLY | O_NONBLOCK | O_CLOEXEC);
+    if (deviceFd == -1)
+        return false;
+
+    bool ok = ioctl(deviceFd, UI_SET_EVBIT, EV_ABS) == 0 &&
+        ioctl(deviceFd, UI_SET_EVBIT, EV_KEY) == 0 &&
+        // A button, so udev tags the device as a joystick
+        ioctl(deviceFd, UI_SET_KEYBIT, BTN_SOUTH) == 0;
+
+    for (int i = 0; ok && i < AxisCount; i++) {
+        uinput_abs_setup abs {};
+        abs.code = axisCodes[i];
+        abs.absinfo.minimum = -32767;
+        abs.absinfo.maximum = 32767;
+        ok = ioctl(deviceFd, UI_SET_ABSBIT, axisCodes[i]) == 0 &&
+            ioctl(deviceFd, UI_ABS_SETUP, &abs) == 0;
+    }
+
+    uinput_setup setup {};
+    setup.id.bustype = BUS_VIRTUAL;
+    setup.id.version = 1;
+    std::strncpy(setup.name, "PLA ALT Virtual Gamepad", UINPUT_MAX_NAME_SIZE - 1);
+
+    if (!ok || ioctl(deviceFd, UI_DEV_SETUP, &setup) != 0 ||
+            ioctl(deviceFd, UI_DEV_CREATE) != 0) {
+        ::close(deviceFd);
+        deviceFd = -1;
+        return false;
+    }
+
+    std::memset(last, 0, sizeof(last));
+    return true;
+}
+
+void VirtualGamepad::close(void)
+{
+    if (deviceFd == -1)
+        return;
+
+    ioctl(deviceFd, UI_DEV_DESTROY);
+    ::close(deviceFd);
+    deviceFd = -1;
+}
+
+void VirtualGamepad::send(const std::int32_t (&axes)[AxisCount])
+{
+    if (deviceFd == -1)
+        return;
+
+    PLA_TRACE_SCOPE("keys", "VirtualGamepad::send");
+
+    // The kernel stamps the events, so their times are left zero
+    input_event events[AxisCount + 1] {};
+    int count = 0;
+    for (int i = 0; i < AxisCount; i++) {
+        if (axes[i] == last[i])
+            continue;
+        events[count].type = EV_ABS;
+        events[count].code = axisCodes[i];
+        events[count].value = axes[i];
+        count++;
+    }
+
+    if (count == 0)
+        return;
+
+    events[count].type = EV_SYN;
+    events[count].code = SYN_REPORT;
+    count++;
+
+    // If the kernel's buffer is full the frame is dropped and retried with
+    // the next one, rather than stalling the input thread
+    auto size = static_cast<ssize_t>(count * sizeof(input_event));
+    if (::write(deviceFd, events, size) == size)
+        std::memcpy(last, axes, sizeof(last));
+}
@@ -0,0 +1,70 @@
+/**
+ * @file virtualgamepad.h
+ * @brief Presents stick and wheel positions to games as a Linux gamepad.
+ */
+#ifndef VIRTUALGAMEPAD_H
+#define VIRTUALGAMEPAD_H
+
+#include <cstdint>
+
+/**
+ * @class VirtualGamepad
+ * @brief A uinput gamepad that the controller thread writes axis positions
+ * to, once per input frame.
+ *
+ * Games see an ordinary joystick ("PLA ALT Virtual Gamepad") with these axes,
+ * each ranging from -32767 to 32767:
+ *     ABS_X, ABS_Y      Primary stick
+ *     ABS_RX, ABS_RY    Right aux stick
+ *     ABS_Z, ABS_RZ     Left aux stick
+ *     ABS_WHEEL         Wheel
+ *
+ * Only axes that changed are written, as one batch ending in SYN_REPORT, so a
+ * frame costs at most one system call. Requires write access to /dev/uinput.
+ */
+class VirtualGamepad
+{
+public:
+    enum Axis {
+        PrimaryX,
+        PrimaryY,
+        RightX,
+        RightY,
+        LeftX,
+        LeftY,
+        Wheel,
+        AxisCount
+    };
+
+    VirtualGamepad(void) = default;
+    ~VirtualGamepad(void);
+
+    VirtualGamepad(const VirtualGamepad&) = delete;
+    VirtualGamepad& operator=(const VirtualGamepad&) = delete;
+
+    /**
+     * Creates the device.
+     * @return True if success
+     */
+    bool open(void);
+
+    /**
+     * Removes the device.
+     */
+    void close(void);
+
+    bool isOpen(void) const
+    { return deviceFd != -1; }
+
+    /**
+     * Moves the axes to the given positions.
+     * @param axes A position for each Axis
+     */
+    void send(const std::int32_t (&axes)[AxisCount]);
+
+private:
+    int deviceFd = -1;
+    std::int32_t last[AxisCount] {};
+};
+
+#endif // VIRTUALGAMEPAD_H
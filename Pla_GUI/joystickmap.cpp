@@ -0,0 +1,137 @@
+#include "joystickmap.h"
+#include "trace.h"
+
+#include <QPainter>
+
+#include <cmath>
+
+JoystickMap::JoystickMap(QWidget *parent) :
+    QWidget(parent),
+    shortThreshold(0),
+    farThreshold(0),
+    primaryAngle(0.7853982),
+    posX(0),
+    posY(0)
+{
+    // The cached layers cover the whole widget
+    setAttribute(Qt::WA_OpaquePaintEvent);
+}
+
+void JoystickMap::setThresholds(int s, int f)
+{
+    if (s == shortThreshold && f == farThreshold)
+        return;
+
+    shortThreshold = s;
+    farThreshold = f;
+    rebuildLayers();
+}
+
+void JoystickMap::setPrimaryAngle(double angle)
+{
+    if (angle == primaryAngle)
+        return;
+
+    primaryAngle = angle;
+    rebuildLayers();
+}
+
+void JoystickMap::setPosition(int x, int y)
+{
+    auto oldZone = currentZone();
+    auto oldPoint = markerPoint();
+
+    posX = x;
+    posY = y;
+
+    // A zone change swaps the background; otherwise only the marker moves
+    if (currentZone() != oldZone)
+        update();
+    else if (markerPoint() != oldPoint)
+        update(QRect(oldPoint, QSize()).united(QRect(markerPoint(), QSize()))
+            .adjusted(-4, -4, 4, 4));
+}
+
+JoystickMap::Zone JoystickMap::currentZone(void) const
+{
+    auto dist = std::sqrt(static_cast<double>(posX) * posX +
+        static_cast<double>(posY) * posY);
+
+    if (dist > farThreshold)
+        return PastFar;
+    else if (dist > shortThreshold)
+        return PastShort;
+    else
+        return Inside;
+}
+
+QPoint JoystickMap::markerPoint(void) const
+{
+    auto size = width();
+    return QPoint(static_cast<int>((posX + 32767) / 65536. * size),
+        static_cast<int>(size - ((posY + 32767) / 65536. * size)));
+}
+
+void JoystickMap::rebuildLayers(void)
+{
+    auto size = width();
+    auto center = QPointF(size / 2, size / 2);
+    auto rf = farThreshold / 32767. * (size / 2.);
+    auto rs = shortThreshold / 32767. * (size / 2.);
+
+    auto offset = std::tan(primaryAngle / 2.) / 2.;
+    auto divLow = static_cast<int>(std::round((0.5 - offset) * size));
+    auto divHigh = static_cast<int>(std::round((0.5 + offset) * size));
+
+    for (int zone = 0; zone < ZoneCount; zone++) {
+        layers[zone] = QPixmap(size, size);
+
+        QPainter pen (&layers[zone]);
+        QPen linePen;
+
+        pen.fillRect(0, 0, size, size, zone == PastFar ? Qt::red : Qt::black);
+        linePen.setWidth(2);
+        linePen.setColor(Qt::white);
+        pen.setPen(linePen);
+        pen.drawRect(0, 0, size, size);
+
+        // Far threshold, filled if between the thresholds
+        linePen.setColor(Qt::red);
+        pen.setBrush(zone == PastShort ? Qt::green : Qt::black);
+        pen.setPen(linePen);
+        pen.drawEllipse(center, rf, rf);
+
+        // Short threshold
+        linePen.setColor(Qt::green);
+        pen.setBrush(Qt::black);
+        pen.setPen(linePen);
+        pen.drawEllipse(center, rs, rs);
+
+        // Sector dividers
+        pen.setPen(Qt::gray);
+        pen.setBrush(Qt::gray);
+        pen.drawLine(0, divHigh, size, divLow);
+        pen.drawLine(0, divLow, size, divHigh);
+        pen.drawLine(divLow, 0, divHigh, size);
+        pen.drawLine(divLow, size, divHigh, 0);
+    }
+
+    update();
+}
+
+void JoystickMap::paintEvent(QPaintEvent *event)
+{
+    PLA_TRACE_SCOPE("gui", "JoystickMap::paintEvent");
+    if (layers[0].width() != width())
+        rebuildLayers();
+
+    QPainter pen (this);
+    pen.drawPixmap(0, 0, layers[currentZone()]);
+
+    pen.setPen(Qt::white);
+    pen.setBrush(Qt::white);
+    pen.drawEllipse(markerPoint(), 3, 3);
+
+    if (event != nullptr)
+        event->accept();
+}
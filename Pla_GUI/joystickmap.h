@@ -0,0 +1,84 @@
+/**
+ * @file joystickmap.h
+ * @brief Live view of a joystick's position against its thresholds.
+ */
+#ifndef JOYSTICKMAP_H
+#define JOYSTICKMAP_H
+
+#include <QPaintEvent>
+#include <QPixmap>
+#include <QPoint>
+#include <QWidget>
+
+/**
+ * @class JoystickMap
+ * @brief Draws the joystick's thresholds, sector lines and current position.
+ *
+ * Everything but the position marker only changes when a threshold or the
+ * sector width changes, so it is drawn once into cached layers. Each repaint
+ * then only has to blit a layer and draw the marker.
+ */
+class JoystickMap : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit JoystickMap(QWidget *parent = nullptr);
+
+    /**
+     * Sets the short and far thresholds to draw, rebuilding the layers.
+     */
+    void setThresholds(int shortThreshold, int farThreshold);
+
+    /**
+     * Sets the primary (cardinal) sector width in radians, rebuilding the
+     * layers.
+     */
+    void setPrimaryAngle(double angle);
+
+    /**
+     * Moves the position marker. Only schedules a repaint if something
+     * visible changed.
+     * @param x Joystick x position, -32767 to 32767
+     * @param y Joystick y position, -32767 to 32767
+     */
+    void setPosition(int x, int y);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+
+private:
+    // Which threshold the position has passed: none, short, or far
+    enum Zone {
+        Inside = 0,
+        PastShort,
+        PastFar,
+        ZoneCount
+    };
+
+    /**
+     * Redraws the cached layers for every zone.
+     */
+    void rebuildLayers(void);
+
+    /**
+     * Finds the zone that the current position is in.
+     */
+    Zone currentZone(void) const;
+
+    /**
+     * Gets the marker's location in widget coordinates.
+     */
+    QPoint markerPoint(void) const;
+
+    QPixmap layers[ZoneCount];
+
+    int shortThreshold;
+    int farThreshold;
+    double primaryAngle;
+
+    int posX;
+    int posY;
+};
+
+#endif // JOYSTICKMAP_H
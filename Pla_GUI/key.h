@@ -87,6 +87,7 @@ public:
         return copy;
     }
     inline int getKey() const { return key; }
+    inline bool isMacro() const { return !macro.empty(); }
 
 private:
     int key;
@@ -0,0 +1,146 @@
+/**
+ * @file keybackend.h
+ * @brief Destinations for the keystrokes that Key::fire() produces.
+ */
+#ifndef KEYBACKEND_H
+#define KEYBACKEND_H
+
+#include <QtGlobal>
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * @class KeyBackend
+ * @brief Receives key presses and releases from Key::fire().
+ *
+ * By default keystrokes go to the operating system through NativeKeyBackend.
+ * Another backend can be installed, e.g. to record keystrokes during replay.
+ * Pointer motion from the PointerEngine goes through the same backend.
+ */
+class KeyBackend
+{
+public:
+    virtual ~KeyBackend(void) = default;
+
+    /**
+     * Sends one key event.
+     * @param key The key, using Qt's key values (e.g. Qt::Key_Down)
+     * @param mod Modifiers to press or release along with the key
+     * @param press True for press, false for release
+     */
+    virtual void send(int key, Qt::KeyboardModifiers mod, bool press) = 0;
+
+    /**
+     * Moves the mouse pointer. Ignored unless overridden.
+     * @param dx Pixels to the right
+     * @param dy Pixels down
+     */
+    virtual void movePointer(int dx, int dy) {
+        (void)dx;
+        (void)dy;
+    }
+
+    /**
+     * Turns the scroll wheel. Ignored unless overridden.
+     * @param dx Steps to the right
+     * @param dy Steps up
+     */
+    virtual void scroll(int dx, int dy) {
+        (void)dx;
+        (void)dy;
+    }
+
+    /**
+     * Gets the backend that keystrokes currently go to.
+     */
+    static KeyBackend& current(void);
+
+    /**
+     * Changes where keystrokes go. The backend must outlive its use.
+     * @param backend The new backend, or nullptr for the native one
+     */
+    static void setCurrent(KeyBackend *backend);
+
+private:
+    static std::atomic<KeyBackend *> active;
+};
+
+/**
+ * @class NativeKeyBackend
+ * @brief Sends keystrokes to the OS (SendInput on Windows, libxdo elsewhere).
+ */
+class NativeKeyBackend : public KeyBackend
+{
+public:
+    void send(int key, Qt::KeyboardModifiers mod, bool press) override;
+    void movePointer(int dx, int dy) override;
+    void scroll(int dx, int dy) override;
+
+#ifndef PLA_WINDOWS
+    /**
+     * Builds the libxdo key sequence (e.g. "ctrl+Shift+a") for a key.
+     * @param text Replaced with the sequence; reusing it avoids allocating
+     */
+    static void keySequence(int key, Qt::KeyboardModifiers mod, std::string& text);
+#endif
+};
+
+/**
+ * @class NullKeyBackend
+ * @brief Discards keystrokes, for measuring the cost of everything else.
+ */
+class NullKeyBackend : public KeyBackend
+{
+public:
+    void send(int, Qt::KeyboardModifiers, bool) override {}
+};
+
+/**
+ * @class RecordingKeyBackend
+ * @brief Keeps every keystroke in memory instead of sending it.
+ *
+ * Events are stamped with a time set by the caller (e.g. the timestamp of the
+ * input frame being replayed), so recordings are deterministic.
+ */
+class RecordingKeyBackend : public KeyBackend
+{
+public:
+    struct Event {
+        std::int64_t timestamp;
+        int key;
+        int mod;
+        bool press;
+
+        bool operator==(const Event& other) const {
+            return timestamp == other.timestamp && key == other.key &&
+                mod == other.mod && press == other.press;
+        }
+    };
+
+    void send(int key, Qt::KeyboardModifiers mod, bool press) override;
+
+    /**
+     * Sets the timestamp given to following events.
+     */
+    void setTime(std::int64_t timestamp);
+
+    std::vector<Event> events(void) const;
+    void clear(void);
+
+    /**
+     * Writes one line per event: "timestamp key modifiers press|release".
+     */
+    void write(std::ostream& out) const;
+
+private:
+    mutable std::mutex lock;
+    std::vector<Event> recorded;
+    std::int64_t time = 0;
+};
+
+#endif // KEYBACKEND_H
@@ -1,21 +1,112 @@
 #include "keysender.h"
 
+#include "config.h"
+#include "latency.h"
+#include "scheduler.h"
+#include "trace.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <iostream>
 
 std::map<Qt::Key, int> KeySender::pressedKeys;
+std::mutex KeySender::outputLock;
+std::mutex KeySender::macroLock;
+std::condition_variable KeySender::macroChanged;
+std::deque<Key> KeySender::macroQueue;
+std::thread KeySender::macroThread;
+bool KeySender::macroPlaying = false;
+bool KeySender::macrosStopping = false;
 
 KeySender::KeySender(unsigned int count) :
-    keys(count, {Key(), false}) {}
+    keys(count, {Key(), false}),
+    turbo(count, {0, 0.5}) {}
 
-void KeySender::sendKey(int index, bool press)
+KeySender::KeySender(const KeySender& other) :
+    keys(other.keys),
+    turbo(other.turbo)
 {
-    if (index < 0 || index >= static_cast<int>(keys.size()))
+    for (auto& key : keys)
+        key.second = false;
+}
+
+KeySender& KeySender::operator=(const KeySender& other)
+{
+    if (this == &other)
+        return *this;
+
+    // The copy comes up released, so release whatever is held first; else
+    // the user's release would be ignored, and a turbo key repeat forever
+    std::unique_lock<std::mutex> lock (outputLock);
+    for (unsigned int i = 0; i < keys.size(); i++) {
+        if (!lock.owns_lock())
+            lock.lock();
+        if (!keys[i].second)
+            continue;
+
+        keys[i].second = false;
+        if (i < turboStates.size() && turboStates[i].active)
+            sendTurbo(i, false, lock);
+        else
+            output(i, false, lock);
+    }
+
+    if (!lock.owns_lock())
+        lock.lock();
+    keys = other.keys;
+    for (auto& key : keys)
+        key.second = false;
+    turbo = other.turbo;
+    return *this;
+}
+
+KeySender::~KeySender(void)
+{
+    if (turboStates.empty())
         return;
-    if (keys[index].second == press)
+
+    // Stop any turbo cycles; a task already running sees the new generation
+    // and doesn't schedule another
+    std::vector<std::uint64_t> tasks;
+    {
+        std::lock_guard<std::mutex> lock (outputLock);
+        for (auto& state : turboStates) {
+            state.generation++;
+            if (state.task != 0)
+                tasks.push_back(state.task);
+        }
+    }
+
+    for (auto task : tasks)
+        Scheduler::cancel(task);
+}
+
+void KeySender::sendKey(int index, bool press)
+{
+    // The number of keys can change (see resizeKeys()), so check under the lock
+    std::unique_lock<std::mutex> lock (outputLock);
+    if (index < 0 || index >= static_cast<int>(keys.size()) ||
+            keys[index].second == press)
         return;
 
+    PLA_TRACE_SCOPE("keys", "KeySender::sendKey");
     keys[index].second = press;
+    Latency::mark(Latency::Dispatch);
+
+    // A key whose turbo was switched off while held still ends its cycle.
+    // Macros aren't repeated, since each repeat would queue behind the last
+    bool turboActive = index < static_cast<int>(turboStates.size()) &&
+        turboStates[index].active;
+    bool turboKey = turbo[index].rate > 0 && !keys[index].first.isMacro();
+    if (press ? turboKey : turboActive)
+        sendTurbo(index, press, lock);
+    else
+        output(index, press, lock);
+}
 
+void KeySender::output(int index, bool press, std::unique_lock<std::mutex>& lock)
+{
     auto tryKeyAction =
         [&](Qt::Key K) {
             if (!press)
@@ -27,6 +118,15 @@ void KeySender::sendKey(int index, bool press)
         };
 
     const auto& key = keys[index].first;
+
+    // Macros aren't shared between actions like keys are, and only play on
+    // press
+    if (key.isMacro()) {
+        if (press)
+            queueMacro(key);
+        return;
+    }
+
     auto mods = key.getModifiers();
     if (mods & Qt::ShiftModifier)
         tryKeyAction(Qt::Key_Shift);
@@ -40,6 +140,127 @@ void KeySender::sendKey(int index, bool press)
     tryKeyAction(static_cast<Qt::Key>(key.getKey()));
 }
 
+void KeySender::sendTurbo(int index, bool press, std::unique_lock<std::mutex>& lock)
+{
+    if (turboStates.size() < keys.size())
+        turboStates.resize(keys.size());
+
+    auto& state = turboStates[index];
+    state.generation++;
+    state.active = press;
+
+    if (press) {
+        // The first press starts the cycle now; it isn't a repeat, so it
+        // isn't measured
+        state.lastPress = 0;
+        auto generation = state.generation;
+        lock.unlock();
+        turboStep(index, generation, Scheduler::now(), true);
+    } else if (state.down) {
+        state.down = false;
+        output(index, false, lock);
+    }
+}
+
+void KeySender::turboStep(int index, std::uint64_t generation, std::int64_t deadline,
+    bool press)
+{
+    std::unique_lock<std::mutex> lock (outputLock);
+
+    // Released, pressed again or resized since this was scheduled
+    if (index >= static_cast<int>(turboStates.size()) ||
+            turboStates[index].generation != generation)
+        return;
+
+    auto& state = turboStates[index];
+    const auto& setting = turbo[index];
+    state.task = 0;
+
+    // Bound to a macro since the cycle started: stop, and leave the key up
+    if (keys[index].first.isMacro()) {
+        if (state.down) {
+            state.down = false;
+            output(index, false, lock);
+        }
+        return;
+    }
+
+    // Turbo switched off while held: stay down until released
+    if (setting.rate <= 0) {
+        if (!state.down) {
+            state.down = true;
+            output(index, true, lock);
+        }
+        return;
+    }
+
+    auto period = static_cast<std::int64_t>(1e9 / setting.rate);
+    auto minimum = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        config::MinimumKeyPulse).count();
+    auto on = std::max(minimum, std::min(period - minimum,
+        static_cast<std::int64_t>(setting.duty * period)));
+
+    state.task = Scheduler::at(deadline + (press ? on : period - on),
+        [this, index, generation, press](std::int64_t next) {
+            turboStep(index, generation, next, !press);
+        });
+
+    if (press) {
+        auto now = Scheduler::now();
+        if (state.lastPress != 0)
+            Latency::recordTurboError(std::abs(now - state.lastPress - period));
+        state.lastPress = now;
+    }
+
+    state.down = press;
+    output(index, press, lock);
+}
+
+void KeySender::setTurbo(int index, double rate, double duty)
+{
+    if (index < 0 || index >= static_cast<int>(turbo.size()))
+        return;
+
+    if (rate > 0)
+        rate = std::max(config::TurboMinRate, std::min(config::TurboMaxRate, rate));
+    turbo[index] = {std::max(0., rate), std::max(0., std::min(1., duty))};
+}
+
+double KeySender::getTurboRate(int index) const
+{
+    if (index < 0 || index >= static_cast<int>(turbo.size()))
+        return 0;
+    return turbo[index].rate;
+}
+
+double KeySender::getTurboDuty(int index) const
+{
+    if (index < 0 || index >= static_cast<int>(turbo.size()))
+        return 0.5;
+    return turbo[index].duty;
+}
+
+std::uint32_t KeySender::getPressedMask(void) const
+{
+    std::lock_guard<std::mutex> lock (outputLock);
+    std::uint32_t mask = 0;
+    for (unsigned int i = 0; i < keys.size() && i < 32; i++) {
+        if (keys[i].second)
+            mask |= 1u << i;
+    }
+
+    return mask;
+}
+
+void KeySender::resizeKeys(unsigned int count)
+{
+    std::lock_guard<std::mutex> lock (outputLock);
+    keys.resize(count, {Key(), false});
+    turbo.resize(count, {0, 0.5});
+    if (turboStates.size() > count)
+        turboStates.resize(count);
+}
+
 QString KeySender::getText(int index) const
 {
     if (index < 0 || index >= static_cast<int>(keys.size()))
@@ -52,6 +273,13 @@ void KeySender::save(QSettings& settings) const
     for (unsigned int i = 0; i < keys.size(); i++) {
         settings.beginGroup(QString::fromStdString(std::to_string(i)));
         keys[i].first.save(settings);
+        if (turbo[i].rate > 0) {
+            settings.setValue("turbo", turbo[i].rate);
+            settings.setValue("turboduty", turbo[i].duty);
+        } else {
+            settings.remove("turbo");
+            settings.remove("turboduty");
+        }
         settings.endGroup();
     }
 }
@@ -61,6 +289,8 @@ void KeySender::load(QSettings &settings)
     for (unsigned int i = 0; i < keys.size(); i++) {
         settings.beginGroup(QString::fromStdString(std::to_string(i)));
         keys[i].first = Key(settings);
+        setTurbo(i, settings.value("turbo", 0).toDouble(),
+            settings.value("turboduty", 0.5).toDouble());
         settings.endGroup();
     }
 }
@@ -71,7 +301,7 @@ bool KeySender::operator==(const KeySender& other) const
         return false;
 
     for (auto i = 0u; i < keys.size(); ++i) {
-        if (keys[i].first != other.keys[i].first)
+        if (keys[i].first != other.keys[i].first || turbo[i] != other.turbo[i])
             return false;
     }
 
@@ -83,3 +313,57 @@ bool KeySender::operator!=(const KeySender& other) const
     return !(*this == other);
 }
 
+void KeySender::finishMacros(void)
+{
+    std::unique_lock<std::mutex> lock (macroLock);
+    macroChanged.wait(lock, [] { return macroQueue.empty() && !macroPlaying; });
+}
+
+void KeySender::stopMacros(void)
+{
+    {
+        std::lock_guard<std::mutex> lock (macroLock);
+        if (!macroThread.joinable())
+            return;
+        macrosStopping = true;
+        macroQueue.clear();
+    }
+    macroChanged.notify_all();
+    macroThread.join();
+
+    std::lock_guard<std::mutex> lock (macroLock);
+    macrosStopping = false;
+}
+
+void KeySender::queueMacro(const Key& macro)
+{
+    {
+        std::lock_guard<std::mutex> lock (macroLock);
+        if (!macroThread.joinable())
+            macroThread = std::thread(playMacros);
+        macroQueue.push_back(macro);
+    }
+    macroChanged.notify_all();
+}
+
+void KeySender::playMacros(void)
+{
+    Trace::setThreadName("macros");
+
+    std::unique_lock<std::mutex> lock (macroLock);
+    while (true) {
+        macroChanged.wait(lock, [] { return macrosStopping || !macroQueue.empty(); });
+        if (macrosStopping)
+            return;
+
+        auto macro = std::move(macroQueue.front());
+        macroQueue.pop_front();
+        macroPlaying = true;
+        lock.unlock();
+        macro.fire(true);
+        lock.lock();
+        macroPlaying = false;
+        macroChanged.notify_all();
+    }
+}
+
@@ -7,16 +7,38 @@
 
 #include "key.h"
 
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
 #include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 /**
  * @class KeySender
  * @brief Keeps a fixed number of keys that can be set or sent as keystrokes.
  * C defines how many keys the class should store.
+ *
+ * Keys may be sent from the controller thread and the Scheduler thread at
+ * once; sending is serialized by one lock shared by all senders.
+ *
+ * Any key can be given a turbo rate, making it repeat for as long as it is
+ * held. Every turbo key, across all senders, is timed by the one Scheduler
+ * thread; each held key has a single pending task at a time.
+ *
+ * Macros take as long as their steps and delays, so they are played on one
+ * thread shared by all senders, in the order they were pressed. Sending a
+ * macro key only queues it, and never holds up the caller.
  */
 class KeySender {
 public:
     KeySender(unsigned int count);
+    // Copies keys and settings, all released. Assigning first releases
+    // any key still held, ending its turbo.
+    KeySender(const KeySender& other);
+    KeySender& operator=(const KeySender& other);
+    virtual ~KeySender(void);
 
     /**
      * Sends the index'th key to the operating system as a keystroke.
@@ -38,6 +60,24 @@ public:
         keys[index].first = Key(args...);
     }
 
+    /**
+     * Gets which keys are currently pressed.
+     * @return A value where bit 'n' is set if key 'n' is pressed
+     */
+    std::uint32_t getPressedMask(void) const;
+
+    /**
+     * Makes the index'th key repeat while held.
+     * Macros are not repeated; on a macro's slot the rate is ignored.
+     * @param index The key to set
+     * @param rate Presses per second (config::TurboMinRate to
+     * config::TurboMaxRate), or 0 to press once as usual
+     * @param duty Fraction of each period the key is held down (0-1)
+     */
+    void setTurbo(int index, double rate, double duty = 0.5);
+    double getTurboRate(int index) const;
+    double getTurboDuty(int index) const;
+
     const Key& getKey(int index) const {
         static Key dummy;
         if (index < 0 || index >= static_cast<int>(keys.size()))
@@ -70,12 +110,93 @@ public:
     // For Editing
     bool operator!=(const KeySender& other) const;
 
+    /**
+     * Waits until every macro queued so far has played.
+     */
+    static void finishMacros(void);
+
+    /**
+     * Stops the macro thread, dropping macros not yet played. Macros sent
+     * afterwards start it again.
+     */
+    static void stopMacros(void);
+
 protected:
     // Stores values for the keys
     std::vector<std::pair<Key, bool>> keys;
 
+    /**
+     * Changes the number of keys. Keys past the new count are dropped, and
+     * should be released first.
+     */
+    void resizeKeys(unsigned int count);
+
 private:
+    struct TurboSetting {
+        double rate;
+        double duty;
+
+        bool operator!=(const TurboSetting& other) const {
+            return rate != other.rate || duty != other.duty;
+        }
+    };
+
+    // A held turbo key's progress
+    struct TurboState {
+        // Changed on every press and release, so stale tasks can tell
+        std::uint64_t generation = 0;
+        std::uint64_t task = 0;
+        // When the key last went down, in Scheduler time
+        std::int64_t lastPress = 0;
+        // Set while held
+        bool active = false;
+        // Set while the keystroke is down
+        bool down = false;
+    };
+
+    // One per key
+    std::vector<TurboSetting> turbo;
+    // Grows as turbo keys are first pressed
+    std::vector<TurboState> turboStates;
+
     static std::map<Qt::Key, int> pressedKeys;
+    // Guards pressedKeys, every sender's pressed states and turbo states
+    static std::mutex outputLock;
+
+    // Macros waiting to play; taken after outputLock, never before it
+    static std::mutex macroLock;
+    static std::condition_variable macroChanged;
+    static std::deque<Key> macroQueue;
+    static std::thread macroThread;
+    static bool macroPlaying;
+    static bool macrosStopping;
+
+    /**
+     * Queues a macro for the macro thread, starting it if needed.
+     */
+    static void queueMacro(const Key& macro);
+
+    static void playMacros(void);
+
+    /**
+     * Presses or releases the index'th key's keystrokes. Called with
+     * outputLock held; may release it.
+     */
+    void output(int index, bool press, std::unique_lock<std::mutex>& lock);
+
+    /**
+     * Starts or stops a turbo key. Called with outputLock held; may release
+     * it.
+     */
+    void sendTurbo(int index, bool press, std::unique_lock<std::mutex>& lock);
+
+    /**
+     * One edge of a turbo key's cycle, run by the Scheduler.
+     * @param generation The key's generation when the cycle started
+     * @param press True to press, false to release
+     */
+    void turboStep(int index, std::uint64_t generation, std::int64_t deadline,
+        bool press);
 };
 
 #endif // KEYSENDER_H
@@ -0,0 +1,180 @@
+#include "latency.h"
+
+#include "config.h"
+
+#include <iomanip>
+
+LatencyHistogram::LatencyHistogram(void) :
+    total(0),
+    largest(0)
+{
+    for (auto& b : buckets)
+        b.store(0, std::memory_order_relaxed);
+}
+
+unsigned int LatencyHistogram::bucketOf(std::uint64_t value)
+{
+    if (value < SubBuckets)
+        return static_cast<unsigned int>(value);
+
+    // Top bit picks the power of two, the next three bits the sub-bucket
+    unsigned int exponent = 63 - static_cast<unsigned int>(__builtin_clzll(value));
+    unsigned int sub = static_cast<unsigned int>(value >> (exponent - 3)) & (SubBuckets - 1);
+    return (exponent - 2) * SubBuckets + sub;
+}
+
+std::int64_t LatencyHistogram::bucketLimit(unsigned int bucket)
+{
+    if (bucket < SubBuckets)
+        return bucket;
+
+    unsigned int exponent = bucket / SubBuckets + 2;
+    std::uint64_t sub = bucket % SubBuckets;
+    auto low = (std::uint64_t(1) << exponent) | (sub << (exponent - 3));
+    return static_cast<std::int64_t>(low + (std::uint64_t(1) << (exponent - 3)) - 1);
+}
+
+void LatencyHistogram::record(std::int64_t nanoseconds)
+{
+    if (nanoseconds < 0)
+        nanoseconds = 0;
+
+    auto bucket = bucketOf(static_cast<std::uint64_t>(nanoseconds));
+    if (bucket >= BucketCount)
+        bucket = BucketCount - 1;
+    buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    total.fetch_add(1, std::memory_order_relaxed);
+
+    auto prev = largest.load(std::memory_order_relaxed);
+    while (nanoseconds > prev &&
+        !largest.compare_exchange_weak(prev, nanoseconds, std::memory_order_relaxed));
+}
+
+void LatencyHistogram::reset(void)
+{
+    for (auto& b : buckets)
+        b.store(0, std::memory_order_relaxed);
+    total.store(0, std::memory_order_relaxed);
+    largest.store(0, std::memory_order_relaxed);
+}
+
+std::int64_t LatencyHistogram::quantile(double q) const
+{
+    auto n = count();
+    if (n == 0)
+        return 0;
+
+    auto rank = static_cast<std::uint64_t>(q * (n - 1)) + 1;
+    std::uint64_t seen = 0;
+    for (unsigned int i = 0; i < BucketCount; i++) {
+        seen += buckets[i].load(std::memory_order_relaxed);
+        if (seen >= rank)
+            return std::min(bucketLimit(i), max());
+    }
+
+    return max();
+}
+
+std::atomic_bool Latency::enabled (false);
+LatencyHistogram Latency::histograms[Latency::StageCount];
+std::atomic<std::int64_t> Latency::expectedPeriod (
+    std::chrono::duration_cast<std::chrono::nanoseconds>(config::InputUpdateFrequency).count());
+std::atomic<unsigned long> Latency::missed (0);
+std::atomic<unsigned long> Latency::rawTransitions (0);
+std::atomic<unsigned long> Latency::transitions (0);
+thread_local std::int64_t Latency::frameStart = 0;
+std::int64_t Latency::lastFrameStart = 0;
+
+std::int64_t Latency::now(void)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Latency::setEnabled(bool enable)
+{
+    enabled.store(enable);
+}
+
+void Latency::setPeriod(std::chrono::nanoseconds period)
+{
+    expectedPeriod.store(period.count());
+}
+
+void Latency::beginFrame(void)
+{
+    if (!isEnabled()) {
+        frameStart = 0;
+        lastFrameStart = 0;
+        return;
+    }
+
+    frameStart = now();
+    if (lastFrameStart != 0) {
+        auto period = frameStart - lastFrameStart;
+        auto expected = expectedPeriod.load(std::memory_order_relaxed);
+        histograms[LoopJitter].record(period > expected ? period - expected
+                                                        : expected - period);
+    }
+    lastFrameStart = frameStart;
+}
+
+void Latency::endFrame(void)
+{
+    frameStart = 0;
+}
+
+void Latency::record(Stage stage)
+{
+    histograms[stage].record(now() - frameStart);
+}
+
+const char *Latency::stageName(Stage stage)
+{
+    switch (stage) {
+    case LoopJitter:
+        return "loop_jitter";
+    case Classify:
+        return "classify";
+    case Dispatch:
+        return "dispatch";
+    case Submit:
+        return "submit";
+    case TimerLateness:
+        return "timer_late";
+    case TurboError:
+        return "turbo_error";
+    default:
+        return "unknown";
+    }
+}
+
+void Latency::reset(void)
+{
+    for (auto& h : histograms)
+        h.reset();
+    missed.store(0);
+    rawTransitions.store(0);
+    transitions.store(0);
+}
+
+void Latency::dump(std::ostream& out)
+{
+    auto micros = [](std::int64_t ns) { return ns / 1000.; };
+
+    out << "stage count p50_us p99_us max_us\n" << std::fixed << std::setprecision(1);
+    for (int i = 0; i < StageCount; i++) {
+        auto stage = static_cast<Stage>(i);
+        const auto& h = histograms[i];
+        out << stageName(stage) << ' ' << h.count() << ' '
+            << micros(h.quantile(0.5)) << ' ' << micros(h.quantile(0.99)) << ' '
+            << micros(h.max()) << '\n';
+    }
+    auto raw = static_cast<long>(rawTransitions.load());
+    auto kept = static_cast<long>(transitions.load());
+    out << "missed_deadlines " << missedDeadlines() << '\n'
+        << "raw_transitions " << raw << '\n'
+        << "transitions " << kept << '\n'
+        << "suppressed_transitions " << raw - kept << '\n';
+    out.flush();
+}
@@ -0,0 +1,193 @@
+/**
+ * @file latency.h
+ * @brief Measures how long controller input takes to become keystrokes.
+ */
+#ifndef LATENCY_H
+#define LATENCY_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+/**
+ * @class LatencyHistogram
+ * @brief Lock-free histogram of durations, in nanoseconds.
+ *
+ * Buckets are log-linear: each power of two is split into eight buckets, so
+ * quantiles are reported to within 12.5%. The maximum is exact.
+ */
+class LatencyHistogram
+{
+public:
+    LatencyHistogram(void);
+
+    /**
+     * Adds a sample. Safe from any thread.
+     */
+    void record(std::int64_t nanoseconds);
+
+    /**
+     * Clears all samples. Samples recorded meanwhile may be lost.
+     */
+    void reset(void);
+
+    std::uint64_t count(void) const {
+        return total.load(std::memory_order_relaxed);
+    }
+    std::int64_t max(void) const {
+        return largest.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Gets the value below which the given fraction of samples fall.
+     * @param q The quantile, 0 to 1
+     * @return The upper bound of the quantile's bucket, in nanoseconds
+     */
+    std::int64_t quantile(double q) const;
+
+private:
+    static constexpr unsigned int SubBuckets = 8;
+    static constexpr unsigned int BucketCount = 64 * SubBuckets;
+
+    static unsigned int bucketOf(std::uint64_t value);
+    static std::int64_t bucketLimit(unsigned int bucket);
+
+    std::array<std::atomic<std::uint64_t>, BucketCount> buckets;
+    std::atomic<std::uint64_t> total;
+    std::atomic<std::int64_t> largest;
+};
+
+/**
+ * @class Latency
+ * @brief Collects input-to-keystroke timings from the controller thread.
+ *
+ * The controller thread calls beginFrame() when it samples the controller,
+ * then the trackers and KeySender call mark() as a frame is classified,
+ * dispatched, and submitted to the OS. Each stage's time since the sample is
+ * recorded in its own histogram, along with how far each loop period strays
+ * from the polling period. Polling deadlines missed outright are counted
+ * separately, even while timing is disabled.
+ *
+ * While enabled, the joystick trackers also count how often their action
+ * changed, and how often it would have changed without input conditioning,
+ * to show how much chatter the conditioning removes.
+ *
+ * While disabled, every call returns after a single relaxed load.
+ */
+class Latency
+{
+public:
+    enum Stage {
+        LoopJitter = 0, // |loop period - configured period|
+        Classify,       // Sample until a tracker has classified its position
+        Dispatch,       // Sample until KeySender changes a key
+        Submit,         // Sample until the keystroke was handed to the OS
+        TimerLateness,  // Scheduler task start - its deadline
+        TurboError,     // |Turbo key's press interval - its requested period|
+        StageCount
+    };
+
+    static void setEnabled(bool enable);
+    inline static bool isEnabled(void) {
+        return enabled.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Starts timing a frame. Must only be called from the controller thread.
+     */
+    static void beginFrame(void);
+
+    /**
+     * Stops timing the current frame; marks until the next beginFrame() are
+     * ignored.
+     */
+    static void endFrame(void);
+
+    /**
+     * Records the time since the current frame was sampled. Ignored outside
+     * of the controller thread (e.g. for macros or GUI previews).
+     */
+    inline static void mark(Stage stage) {
+        if (isEnabled() && frameStart != 0)
+            record(stage);
+    }
+
+    /**
+     * Sets the polling period that loop jitter is measured against.
+     */
+    static void setPeriod(std::chrono::nanoseconds period);
+
+    /**
+     * Counts polling deadlines that passed before the controller thread was
+     * ready for them.
+     */
+    inline static void addMissedDeadlines(unsigned long count) {
+        missed.fetch_add(count, std::memory_order_relaxed);
+    }
+    inline static unsigned long missedDeadlines(void) {
+        return missed.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Records how late a Scheduler task started.
+     */
+    inline static void recordTimerLateness(std::int64_t ns) {
+        if (isEnabled())
+            histograms[TimerLateness].record(ns);
+    }
+
+    /**
+     * Records how far a turbo key's press interval was from its period.
+     */
+    inline static void recordTurboError(std::int64_t ns) {
+        if (isEnabled())
+            histograms[TurboError].record(ns);
+    }
+
+    /**
+     * Counts one classified sample.
+     * @param raw True if the unconditioned position changed action
+     * @param conditioned True if the conditioned position changed action
+     */
+    inline static void countTransition(bool raw, bool conditioned) {
+        if (raw)
+            rawTransitions.fetch_add(1, std::memory_order_relaxed);
+        if (conditioned)
+            transitions.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    static const LatencyHistogram& histogram(Stage stage) {
+        return histograms[stage];
+    }
+    static const char *stageName(Stage stage);
+
+    /**
+     * Clears all histograms and counters.
+     */
+    static void reset(void);
+
+    /**
+     * Writes one line per stage: "name count p50 p99 max", times in
+     * microseconds, then "name count" for each counter.
+     */
+    static void dump(std::ostream& out);
+
+private:
+    static void record(Stage stage);
+    static std::int64_t now(void);
+
+    static std::atomic_bool enabled;
+    static LatencyHistogram histograms[StageCount];
+    static std::atomic<std::int64_t> expectedPeriod;
+    static std::atomic<unsigned long> missed;
+    static std::atomic<unsigned long> rawTransitions;
+    static std::atomic<unsigned long> transitions;
+
+    // Controller-thread only
+    static thread_local std::int64_t frameStart;
+    static std::int64_t lastFrameStart;
+};
+
+#endif // LATENCY_H
@@ -0,0 +1,33 @@
+#include "lazytab.h"
+
+LazyTab::LazyTab(std::function<QWidget *(void)> f, QWidget *parent) :
+    QWidget(parent),
+    factory(f),
+    content(nullptr)
+{
+
+}
+
+void LazyTab::showEvent(QShowEvent *event)
+{
+    if (content == nullptr) {
+        content = factory();
+        factory = nullptr;
+
+        content->setParent(this);
+        content->setGeometry(rect());
+        content->show();
+    }
+
+    if (event != nullptr)
+        event->accept();
+}
+
+void LazyTab::resizeEvent(QResizeEvent *event)
+{
+    if (content != nullptr)
+        content->setGeometry(rect());
+
+    if (event != nullptr)
+        event->accept();
+}
@@ -0,0 +1,57 @@
+/**
+ * @file lazytab.h
+ * @brief Tab page that builds its contents on first use.
+ */
+#ifndef LAZYTAB_H
+#define LAZYTAB_H
+
+#include <QResizeEvent>
+#include <QShowEvent>
+#include <QWidget>
+
+#include <functional>
+
+/**
+ * @class LazyTab
+ * @brief Placeholder page for a QTabWidget, which constructs the real tab the
+ * first time it is shown.
+ *
+ * This keeps tabs (along with their dialogs and images) from being built
+ * until the user actually opens them.
+ */
+class LazyTab : public QWidget
+{
+    Q_OBJECT
+
+public:
+    /**
+     * Constructs the placeholder.
+     * @param factory Called once to create the real tab
+     * @param parent The tab widget's parent
+     */
+    LazyTab(std::function<QWidget *(void)> factory, QWidget *parent = nullptr);
+
+    /**
+     * Gets the real tab, or nullptr if it has not been created yet.
+     */
+    inline QWidget *widget(void) const {
+        return content;
+    }
+
+protected:
+    /**
+     * Creates the real tab if this is the first time being shown.
+     */
+    void showEvent(QShowEvent *event) override;
+
+    /**
+     * Keeps the real tab the same size as this page.
+     */
+    void resizeEvent(QResizeEvent *event) override;
+
+private:
+    std::function<QWidget *(void)> factory;
+    QWidget *content;
+};
+
+#endif // LAZYTAB_H
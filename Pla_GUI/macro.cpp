@@ -1,5 +1,6 @@
 #include "macro.h"
 #include "config.h"
+#include "trace.h"
 
 #include <chrono>
 #include <thread>
@@ -87,8 +88,11 @@ void Macro::fire(const std::string& name)
     if (macro == macros.end())
         return;
 
+    PLA_TRACE_SCOPE("keys", "Macro::fire");
+
     // Loop through all Actions
     for (const auto& a : (*macro).second) {
+        PLA_TRACE_SCOPE("keys", "Macro step");
         a.key.fire(a.press);
         std::this_thread::sleep_for(std::max(config::MinimumMacroDelay, a.delay));
     }
@@ -1,4 +1,5 @@
 #include "macrotab.h"
+#include "assets.h"
 #include "controller.h"
 #include "mainwindow.h"
 #include "macrorecorder.h"
@@ -35,11 +36,11 @@ MacroTab::MacroTab(QWidget *parent) :
     recorder(this),
     ignoreNextMacroChange(false)
 {
-    macroDelete.setIcon(QIcon("assets/macro-trash.png"));
-    actionRemove.setIcon(QIcon("assets/macro-trash.png"));
-    actionUp.setIcon(QIcon("assets/macro-up.png"));
-    actionDown.setIcon(QIcon("assets/macro-down.png"));
-    delayBeginRecord.setIcon(QIcon("assets/macro-record.png"));
+    macroDelete.setIcon(Assets::icon("macro-trash.png"));
+    actionRemove.setIcon(Assets::icon("macro-trash.png"));
+    actionUp.setIcon(Assets::icon("macro-up.png"));
+    actionDown.setIcon(Assets::icon("macro-down.png"));
+    delayBeginRecord.setIcon(Assets::icon("macro-record.png"));
 
     // Set geometry
     lMacro.setGeometry(70, 40, 200, 20);
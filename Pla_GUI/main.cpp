@@ -1,14 +1,22 @@
 #include "mainwindow.h"
+#include "assets.h"
+#include "clientwindow.h"
+#include "config.h"
 #include "controller.h"
-#include "macro.h"
+#include "controlserver.h"
+#include "engine.h"
 #include "profile.h"
 //#include "runguard.h"
 #include "serial.h"
 
 #include <QApplication>
+#include <QCommandLineParser>
 #include <QFile>
+#include <QFutureWatcher>
 #include <QMessageBox>
 #include <QSharedMemory>
+#include <QTimer>
+#include <QtConcurrent/QtConcurrent>
 
 #include <SDL2/SDL.h>
 #include <atomic>
@@ -24,6 +32,15 @@
 
 int main(int argc, char *argv[])
 {
+    // Log how long each startup phase takes, so regressions are visible
+    auto startTime = std::chrono::steady_clock::now();
+    auto logPhase = [&startTime](const char *phase) {
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - startTime);
+        std::cout << "Startup: " << phase << " at " << elapsed.count() << "ms, "
+                  << Engine::residentMemory() << "kB resident" << std::endl;
+    };
+
     // Base initialization, and stylesheet loading
     QApplication a (argc, argv);
     QFile styleSheet ("assets/stylesheet.txt");
@@ -37,36 +54,109 @@ int main(int argc, char *argv[])
     a.setStyleSheet(QString(styleSheet.readAll()));
     a.setQuitOnLastWindowClosed(true);
 
-    // Check if an instance is already running
-    QSharedMemory runGuard ("PLA_ALT_runGuardKey");
+    QCommandLineParser args;
+    QCommandLineOption startMinimized ("minimized",
+        "Start hidden in the system tray.");
+    args.addHelpOption();
+    args.addOption(startMinimized);
+    Engine::addOptions(args);
+    args.process(a);
+    if (!Engine::checkOptions(args))
+        return 1;
+
+    // Check if an instance is already running; if so, hand it our request
+    QSharedMemory runGuard (Engine::RunGuardKey);
     if (!runGuard.create(1)) {
+        auto commands = Engine::forwardedCommands(args);
+        if (!args.isSet(startMinimized))
+            commands.append("show");
+        QStringList replies;
+        if (commands.isEmpty() || ControlServer::send(commands, &replies))
+            return 0;
+
+        // PLA_ALTd answers, but has no window to show; attach to it instead
+        bool answered = replies.size() == commands.size();
+        if (answered && !args.isSet(startMinimized) && replies.last().startsWith("error")) {
+            ClientWindow client;
+            if (client.attach()) {
+                client.show();
+                return a.exec();
+            }
+        } else if (answered) {
+            // The window was shown, but e.g. --profile named no profile
+            for (const auto& reply : replies) {
+                if (reply.startsWith("error"))
+                    std::cerr << reply.toStdString() << std::endl;
+            }
+            return 1;
+        }
+
         QMessageBox::information(nullptr, "PLA ALT",
-            "PLA ALT is already running.\n"
-            "The program may be accessed through the system tray.",
+            "PLA ALT or PLA_ALTd is already running, but isn't answering.\n"
+            "Close it before starting PLA ALT again.",
             QMessageBox::Ok);
         return 0;
     }
 
-    // Load controller settings
-    Profile::openFirst();
-    Macro::load(Profile::current());
-    Controller::load(Profile::current());
-
-    // Attempt to connect to the controller
-    if (!Controller::init()) {
-        // No controller
-        QMessageBox::information(nullptr, "Controller Disconnected",
-             "Unable to find the PLA ALT controller. Please connect the controller "
-             "to use it with this program.", QMessageBox::Ok);
-    }
+    logPhase("application ready");
+
+    // Read controller settings while the window is being built
+    bool namedProfile = args.isSet("profile");
+    if (!namedProfile)
+        Profile::openFirstAsync();
 
-    // Show the main window
     MainWindow w;
-    w.show();
+    logPhase("window built");
+
+    if (namedProfile)
+        Profile::open(args.value("profile"));
+    else
+        Profile::finishLoading();
+    logPhase("profile loaded");
+
+    // Start searching for the controller
+    bool sdlReady = Engine::start(args);
+    logPhase("controller init");
+
+    QObject::connect(Engine::controlServer(), &ControlServer::showRequested, [&w] {
+        w.show();
+        w.raise();
+        w.activateWindow();
+    });
+
+    QObject::connect(&w, &MainWindow::firstPaint, [&logPhase] {
+        logPhase("first paint");
+    });
+
+    // Show the main window, unless it should start in the tray
+    if (args.isSet(startMinimized) && MainWindow::getTrayIcon() != nullptr) {
+        logPhase("started in tray");
+    } else {
+        w.show();
+        logPhase("window shown");
+    }
+
+    // Decode images in the background once the event loop is idle
+    QTimer::singleShot(0, &Assets::preload);
+
+    // Give the controller time to connect without holding up startup
+    auto connectWatcher = new QFutureWatcher<bool>(&w);
+    QObject::connect(connectWatcher, &QFutureWatcher<bool>::finished, [connectWatcher] {
+        if (!connectWatcher->result()) {
+            // No controller
+            QMessageBox::information(nullptr, "Controller Disconnected",
+                 "Unable to find the PLA ALT controller. Please connect the controller "
+                 "to use it with this program.", QMessageBox::Ok);
+        }
+    });
+    connectWatcher->setFuture(QtConcurrent::run([sdlReady] {
+        return sdlReady && Controller::waitForConnection(config::ConnectionWaitTimeout);
+    }));
+
     auto ret = a.exec();
 
     // Close connections when finished
-    Controller::end();
+    Engine::stop();
 
     return ret;
 }
@@ -2,6 +2,7 @@
 
 #include "config.h"
 #include "colortab.h"
+#include "lazytab.h"
 #include "macrotab.h"
 #include "profile.h"
 #include "profiletab.h"
@@ -9,6 +10,7 @@
 #include "wheeltab.h"
 
 #include "controller.h"
+#include "eventbus.h"
 
 #include <QApplication>
 #include <QMessageBox>
@@ -21,8 +23,10 @@ MainWindow::MainWindow(QWidget *parent) :
     profileMenu(nullptr),
     profileActionGroup(nullptr),
     lVersion(config::versionString, this),
+    diagnostics(nullptr),
     lastTabIndex(0),
-    done(false)
+    done(false),
+    painted(false)
 {
     // Keep the window at a fixed size.
     setWindowTitle("PLA ALT");
@@ -36,10 +40,12 @@ MainWindow::MainWindow(QWidget *parent) :
         // Create the context menu for the system tray icon
         auto systemTrayMenu = new QMenu();
         profileMenu = systemTrayMenu->addMenu("Set profile...");
+        auto diagnosticsAction = systemTrayMenu->addAction("Diagnostics...");
         systemTrayMenu->addSeparator();
         auto quitAction = systemTrayMenu->addAction("Exit PLA ALT");
 
         connect(quitAction, SIGNAL(triggered(bool)), this, SLOT(handleQuit(bool)));
+        connect(diagnosticsAction, SIGNAL(triggered()), this, SLOT(showDiagnostics()));
 
         profileActionGroup = new QActionGroup(profileMenu);
         connect(profileMenu, SIGNAL(aboutToShow()), this, SLOT(updateProfilesMenu()));
@@ -49,6 +55,10 @@ MainWindow::MainWindow(QWidget *parent) :
             this, SLOT(handleTray(QSystemTrayIcon::ActivationReason)));
         trayIcon->setContextMenu(systemTrayMenu);
         trayIcon->show();
+
+        auto bus = EventBus::instance();
+        connect(bus, SIGNAL(connectionChanged(bool)), this, SLOT(showConnectionChange(bool)));
+        connect(bus, SIGNAL(error(QString)), this, SLOT(showError(QString)));
     }
 
     lVersion.setAlignment(Qt::AlignRight);
@@ -57,12 +67,12 @@ MainWindow::MainWindow(QWidget *parent) :
     // Tab widget starts with a Y of 80px, so a banner can be at the top of the window
     tabs.setGeometry(0, 88, 900, 500);
 
-    // Add tabs
-    tabs.addTab(new ProfileTab(this), "PROFILES");
-    tabs.addTab(new ColorTab(this), "LIGHTS");
-    tabs.addTab(new ProgramTab(this), "PROGRAMMING");
-    tabs.addTab(new WheelTab(this), "WHEEL");
-    tabs.addTab(new MacroTab(this), "MACROS");
+    // Add tabs; each is only built once it is first opened
+    tabs.addTab(new LazyTab([this] { return new ProfileTab(this); }), "PROFILES");
+    tabs.addTab(new LazyTab([this] { return new ColorTab(this); }), "LIGHTS");
+    tabs.addTab(new LazyTab([this] { return new ProgramTab(this); }), "PROGRAMMING");
+    tabs.addTab(new LazyTab([this] { return new WheelTab(this); }), "WHEEL");
+    tabs.addTab(new LazyTab([this] { return new MacroTab(this); }), "MACROS");
 
     connect(&tabs, SIGNAL(currentChanged(int)), this, SLOT(changeTab(int)));
     changeTab(0);
@@ -103,6 +113,12 @@ bool MainWindow::eventFilter(QObject *, QEvent *event)
         if (QApplication::activeWindow() == nullptr)
             Controller::setEnabled(true);
         break;
+    case QEvent::Paint:
+        if (!painted) {
+            painted = true;
+            emit firstPaint();
+        }
+        break;
     default:
         break;
     }
@@ -116,10 +132,12 @@ void MainWindow::changeTab(int index)
         return;
 
     // Check if tab is a SavableTab, if so, see if save prompt is needed
-    auto tab = dynamic_cast<SavableTab*>(tabs.widget(lastTabIndex));
+    // (tabs that were never opened can't have been modified)
+    auto page = qobject_cast<LazyTab*>(tabs.widget(lastTabIndex));
+    auto tab = page ? dynamic_cast<SavableTab*>(page->widget()) : nullptr;
     if (tab != nullptr && tab->isModified()) {
         // Return focus to modified tab
-        tabs.setCurrentWidget(dynamic_cast<QWidget*>(tab));
+        tabs.setCurrentIndex(lastTabIndex);
 
         auto choice = QMessageBox::warning(this, "Unsaved Changes",
             "Would you like to save your changes?", QMessageBox::Yes,
@@ -156,6 +174,16 @@ void MainWindow::handleQuit(bool unused)
     close();
 }
 
+void MainWindow::showDiagnostics(void)
+{
+    if (diagnostics == nullptr)
+        diagnostics = new DiagnosticsDialog(this);
+
+    diagnostics->show();
+    diagnostics->raise();
+    diagnostics->activateWindow();
+}
+
 void MainWindow::handleTray(QSystemTrayIcon::ActivationReason reason)
 {
     // On left click, show the main window (this)
@@ -165,6 +193,17 @@ void MainWindow::handleTray(QSystemTrayIcon::ActivationReason reason)
     }
 }
 
+void MainWindow::showConnectionChange(bool connected)
+{
+    trayIcon->showMessage("PLA", connected ? "Controller connected!" :
+        "Controller disconnected.");
+}
+
+void MainWindow::showError(const QString& message)
+{
+    trayIcon->showMessage("PLA ALT", message, QSystemTrayIcon::Warning);
+}
+
 void MainWindow::updateProfilesMenu(void)
 {
     profileActionGroup->actions().clear();
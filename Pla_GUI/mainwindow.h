@@ -5,6 +5,8 @@
 #ifndef MAINWINDOW_H
 #define MAINWINDOW_H
 
+#include "diagnosticsdialog.h"
+
 #include <QCloseEvent>
 #include <QLabel>
 #include <QMainWindow>
@@ -35,6 +37,11 @@ public:
 signals:
     void exitingProgram(void);
 
+    /**
+     * Emitted once, when the window is painted for the first time.
+     */
+    void firstPaint(void);
+
 private slots:
     /**
      * Prompts to save changes if tab is changed before saving.
@@ -52,6 +59,17 @@ private slots:
      */
     void handleQuit(bool);
 
+    /**
+     * Called through system tray, shows the latency diagnostics.
+     */
+    void showDiagnostics(void);
+
+    /**
+     * Shows engine events as tray messages.
+     */
+    void showConnectionChange(bool connected);
+    void showError(const QString& message);
+
     // These are for the tray menu's profile selection
     void updateProfilesMenu(void);
     void loadProfile(bool);
@@ -69,9 +87,11 @@ private:
     QMenu *profileMenu;
     QActionGroup *profileActionGroup;
     QLabel lVersion;
+    DiagnosticsDialog *diagnostics;
 
     int lastTabIndex;
     bool done;
+    bool painted;
 };
 
 #endif // MAINWINDOW_H
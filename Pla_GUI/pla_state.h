@@ -0,0 +1,158 @@
+/**
+ * @file pla_state.h
+ * @brief Layout of the shared-memory segment PLA ALT exports its live
+ * controller state through, and helpers for reading it.
+ *
+ * This header is plain C so overlays and other tools can include it as-is.
+ * Start PLA ALT with --export-state, then:
+ *
+ *     const struct pla_state_shm *shm = pla_state_open();
+ *     struct pla_state state;
+ *     if (shm != NULL && pla_state_read(shm, &state))
+ *         printf("%d %d\n", state.primary_x, state.primary_y);
+ *
+ * The segment is updated once per input frame. Reading it is a plain memory
+ * copy; no system calls are made after pla_state_open().
+ *
+ * Requires GCC or Clang (for the __atomic builtins) on a POSIX system. Link
+ * with -lrt on older C libraries.
+ */
+#ifndef PLA_STATE_H
+#define PLA_STATE_H
+
+#include <fcntl.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Name passed to shm_open(). */
+#define PLA_STATE_SHM_NAME "/pla_alt_state"
+/** Value of pla_state_shm.magic ("PLAS"). */
+#define PLA_STATE_MAGIC 0x53414C50u
+/** Bumped whenever the layout below changes incompatibly. */
+#define PLA_STATE_VERSION 1u
+/** Number of 32-bit words in struct pla_state. */
+#define PLA_STATE_WORDS 32
+
+/**
+ * One input frame. Every field is 32 bits wide.
+ *
+ * Axes range from -32767 to 32767, with the joysticks' x axes inverted the
+ * same way PLA ALT uses them. Bit n of buttons is set while joystick button n
+ * is held. Bit n of an *_actions field is set while that tracker's action n is
+ * pressed (for the joysticks, action 0 is up and actions go clockwise; bit 16
+ * is the stick's button).
+ */
+struct pla_state {
+    int32_t left_x;
+    int32_t left_y;
+    int32_t right_x;
+    int32_t right_y;
+    int32_t primary_x;
+    int32_t primary_y;
+    int32_t wheel;
+    uint32_t buttons;
+    int32_t pg;
+    uint32_t left_actions;
+    uint32_t right_actions;
+    uint32_t primary_actions;
+    uint32_t steering_actions;
+    /** Read time, in CLOCK_MONOTONIC nanoseconds, split into halves. */
+    uint32_t timestamp_lo;
+    uint32_t timestamp_hi;
+    /** Number of frames published; zero until the controller connects. */
+    uint32_t frame;
+    /** Non-zero while a controller is connected. */
+    uint32_t connected;
+    uint32_t reserved[PLA_STATE_WORDS - 17];
+};
+
+/**
+ * The whole segment. The first four words never move between versions.
+ */
+struct pla_state_shm {
+    uint32_t magic;
+    uint32_t version;
+    /** sizeof(struct pla_state_shm) as written by PLA ALT. */
+    uint32_t size;
+    /** Odd while the state is being written; see pla_state_read(). */
+    uint32_t sequence;
+    struct pla_state state;
+};
+
+/**
+ * Maps the segment read-only.
+ * @return The segment, or NULL if PLA ALT is not exporting state
+ */
+static inline const struct pla_state_shm *pla_state_open(void)
+{
+    const struct pla_state_shm *shm;
+    void *map;
+    int fd = shm_open(PLA_STATE_SHM_NAME, O_RDONLY, 0);
+    if (fd == -1)
+        return NULL;
+
+    map = mmap(NULL, sizeof(struct pla_state_shm), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+        return NULL;
+
+    shm = (const struct pla_state_shm *)map;
+    if (shm->magic != PLA_STATE_MAGIC || shm->version != PLA_STATE_VERSION) {
+        munmap(map, sizeof(struct pla_state_shm));
+        return NULL;
+    }
+
+    return shm;
+}
+
+/**
+ * Unmaps a segment returned by pla_state_open().
+ */
+static inline void pla_state_close(const struct pla_state_shm *shm)
+{
+    if (shm != NULL)
+        munmap((void *)shm, sizeof(struct pla_state_shm));
+}
+
+/**
+ * Copies out the latest complete frame.
+ * @param shm The mapped segment
+ * @param out Where to put the frame
+ * @return Non-zero on success, zero if no consistent copy could be made
+ */
+static inline int pla_state_read(const struct pla_state_shm *shm,
+    struct pla_state *out)
+{
+    const uint32_t *src = (const uint32_t *)&shm->state;
+    uint32_t *dst = (uint32_t *)out;
+    int tries, i;
+
+    /* The writer holds the sequence odd for well under a microsecond, so a
+       bounded number of retries is plenty */
+    for (tries = 0; tries < 1000; tries++) {
+        uint32_t before = __atomic_load_n(&shm->sequence, __ATOMIC_ACQUIRE);
+        if (before & 1)
+            continue;
+
+        for (i = 0; i < PLA_STATE_WORDS; i++)
+            dst[i] = __atomic_load_n(&src[i], __ATOMIC_RELAXED);
+
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&shm->sequence, __ATOMIC_RELAXED) == before)
+            return 1;
+    }
+
+    return 0;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PLA_STATE_H */
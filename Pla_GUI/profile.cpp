@@ -1,11 +1,15 @@
 #include "profile.h"
 #include "controller.h"
+#include "eventbus.h"
 #include "macro.h"
 #include "serial.h"
+#include "trace.h"
 
+#include <QCoreApplication>
 #include <QDir>
 #include <QFileInfo>
 #include <QStandardPaths>
+#include <QtConcurrent/QtConcurrent>
 
 static const QString profileFolderPath = (QStandardPaths::writableLocation(QStandardPaths::StandardLocation::ConfigLocation) + "/PLA/profiles/");
 static const QString profileExtension (".ini");
@@ -27,8 +31,31 @@ QSettings* profileObject(const QString& name)
     return new QSettings(profilePath(name), QSettings::IniFormat);
 }
 
+/**
+ * Creates the profile's file if needed, and reads it.
+ * @param name The profile's name
+ * @param newProfile Set to true if the file had to be created
+ */
+QSettings* readProfile(const QString& name, bool& newProfile)
+{
+    QFile file (profilePath(name));
+    newProfile = !file.exists();
+    if (newProfile) {
+        file.open(QFile::WriteOnly);
+        file.write("\n");
+        file.close();
+    }
+
+    auto loaded = profileObject(name);
+    // Force the file to be parsed now, rather than on first access
+    loaded->childGroups();
+    return loaded;
+}
+
 QSettings *Profile::settings = nullptr;
 QString Profile::settingsName;
+QFuture<QSettings *> Profile::pendingSettings;
+bool Profile::pendingIsNew = false;
 
 Profile *Profile::instance()
 {
@@ -45,21 +72,22 @@ void Profile::open(const QString &name)
     if (name == settingsName)
         return;
 
+    PLA_TRACE_SCOPE("profile", "Profile::open");
+    bool newProfile;
+    auto loaded = readProfile(name, newProfile);
+    apply(name, loaded, newProfile);
+}
+
+void Profile::apply(const QString& name, QSettings *loaded, bool newProfile)
+{
+    PLA_TRACE_SCOPE("profile", "Profile::apply");
     if (settings != nullptr) {
         settings->sync();
         delete settings;
     }
 
-    QFile file (profilePath(name));
-    bool newProfile = !file.exists();
-    if (newProfile) {
-        file.open(QFile::WriteOnly);
-        file.write("\n");
-        file.close();
-    }
-
     settingsName = name;
-    settings = profileObject(settingsName);
+    settings = loaded;
 
     Controller::load(*settings);
     Macro::load(*settings);
@@ -68,6 +96,7 @@ void Profile::open(const QString &name)
         save();
 
     profileInstance.emitProfileChanged();
+    EventBus::post(EngineEvent::ProfileChanged);
 }
 
 void Profile::openFirst(void)
@@ -76,6 +105,33 @@ void Profile::openFirst(void)
     open(profiles.empty() ? "Profile 1" : profiles[0]);
 }
 
+void Profile::openFirstAsync(void)
+{
+    auto *mainThread = QCoreApplication::instance()->thread();
+
+    pendingSettings = QtConcurrent::run([mainThread] {
+        auto profiles = list();
+        auto loaded = readProfile(profiles.empty() ? "Profile 1" : profiles[0],
+            pendingIsNew);
+        // The settings will be owned and used by the main thread
+        loaded->moveToThread(mainThread);
+        return loaded;
+    });
+}
+
+void Profile::finishLoading(void)
+{
+    if (pendingSettings.isCanceled())
+        return;
+
+    auto loaded = pendingSettings.result();
+    pendingSettings = QFuture<QSettings *>();
+
+    // The name is recovered from the file, as list() was called on the
+    // loading thread
+    apply(QFileInfo(loaded->fileName()).baseName(), loaded, pendingIsNew);
+}
+
 void Profile::remove(void)
 {
     auto profiles = list();
@@ -122,6 +178,7 @@ void Profile::copy(const QString& newName)
 
 void Profile::save(void)
 {
+    PLA_TRACE_SCOPE("profile", "Profile::save");
     settings->sync();
 }
 
@@ -5,6 +5,7 @@
 #ifndef PROFILE_H
 #define PROFILE_H
 
+#include <QFuture>
 #include <QSettings>
 
 /**
@@ -24,6 +25,19 @@ public:
      */
     static void openFirst(void);
 
+    /**
+     * Starts reading the first profile on a background thread, so that file
+     * parsing can overlap other startup work.
+     * finishLoading() must be called before the profile is used.
+     */
+    static void openFirstAsync(void);
+
+    /**
+     * Waits for openFirstAsync() to finish reading, then applies the profile
+     * to the controller and macros.
+     */
+    static void finishLoading(void);
+
     /**
      * Removes the currently open profile, permanently deleting it.
      */
@@ -70,6 +84,16 @@ signals:
 private:
     static QSettings *settings;
     static QString settingsName;
+    static QFuture<QSettings *> pendingSettings;
+    static bool pendingIsNew;
+
+    /**
+     * Makes the given, already read, settings the current profile.
+     * @param name The profile's name
+     * @param loaded The profile's settings; ownership is taken
+     * @param newProfile True if the profile file was just created
+     */
+    static void apply(const QString& name, QSettings *loaded, bool newProfile);
 
     void emitProfileChanged();
 
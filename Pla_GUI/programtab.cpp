@@ -1,5 +1,6 @@
 #include "programtab.h"
 
+#include "assets.h"
 #include "controller.h"
 #include "profile.h"
 #include "serial.h"
@@ -18,11 +19,7 @@ ProgramTab::ProgramTab(QWidget *parent) :
     lButtonAction("JOYSTICK\nBUTTON ACTION", this),
     separator(this),
     lJoystickGuide(this),
-    pixJoystick("assets/joystick.png"),
-    pixPJoystick("assets/joystick-large.png"),
-    pixArrow("assets/arrow.png"),
     lArrowDown(this),
-    pixArrowDown("assets/arrow-down.png"),
     useLeftJoystick("LEFT AUX JOYSTICK", this),
     useRightJoystick("RIGHT AUX JOYSTICK", this),
     usePrimaryJoystick("PRIMARY JOYSTICK", this),
@@ -67,19 +64,21 @@ ProgramTab::ProgramTab(QWidget *parent) :
     lJoystick.setAlignment(Qt::AlignCenter);
     lSequencer.setAlignment(Qt::AlignCenter);
     lButtonAction.setAlignment(Qt::AlignCenter);
+    auto pixArrow = Assets::pixmap("arrow.png");
     for (int i = 0; i < 3; ++i) {
         lArrow[i].setParent(this);
         lArrow[i].setPixmap(pixArrow);
         lArrow[i].setGeometry(98, 247 + i * 53, 30, 32);
     }
-    lArrowDown.setPixmap(pixArrowDown);
+    lArrowDown.setPixmap(Assets::pixmap("arrow-down.png"));
     lArrowDown.setGeometry(200, 378, 20, 10);
 
     // Set up PG buttons and joystick images
     lEnterKeyOrMacro.setGeometry(400, 145, 112, 60);
     lEnterKeyOrMacro.setAlignment(Qt::AlignCenter);
-    lJoystickGuide.setPixmap(pixPJoystick);
+    lJoystickGuide.setPixmap(Assets::pixmap("joystick-large.png"));
     lJoystickGuide.setGeometry(410, 205, 108, 117);
+    auto pixJoystick = Assets::pixmap("joystick.png");
     for (int i = 0; i < 8; i++) {
         auto button = new QPushButton(QString("MAP PG_") + static_cast<char>('1' + i), this);
         button->setGeometry(11 + 114 * i, 10, 80, 20);
@@ -99,13 +99,9 @@ private:
 
     QLabel lJoystickGuide;
     QLabel lPGJoystick[8];
-    QPixmap pixJoystick;
-    QPixmap pixPJoystick;
 
     QLabel lArrow[3];
-    QPixmap pixArrow;
     QLabel lArrowDown;
-    QPixmap pixArrowDown;
 
     QRadioButton useLeftJoystick;
     QRadioButton useRightJoystick;
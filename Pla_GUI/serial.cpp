@@ -1,5 +1,6 @@
 #include "serial.h"
 #include "config.h"
+#include "trace.h"
 
 // Include platform-specific libraries
 #ifdef PLA_WINDOWS
@@ -8,6 +9,7 @@
 #include <cstring>
 #else
 #include <fcntl.h>
+#include <poll.h>
 #include <string.h>
 #include <unistd.h>
 #endif
@@ -34,6 +36,24 @@ bool Serial::open(void)
     return false;
 }
 
+bool Serial::open(const std::string& device)
+{
+    PLA_TRACE_SCOPE("serial", "Serial::open");
+#ifdef PLA_WINDOWS
+    // Allow plain "COMx" names, which need the device namespace prefix
+    auto port = device.compare(0, 3, "COM") == 0 ? "\\\\.\\" + device : device;
+#else
+    const auto& port = device;
+#endif
+
+    if (nativeOpenPort(port)) {
+        std::cout << "Controller on " << port << std::endl;
+        return true;
+    }
+
+    return false;
+}
+
 void Serial::close(void)
 {
 #ifdef PLA_WINDOWS
@@ -73,17 +93,20 @@ void Serial::sendColor(unsigned char r, unsigned char g, unsigned char b)
 
 void Serial::sendColor(void)
 {
+    PLA_TRACE_SCOPE("serial", "Serial::sendColor");
     nativeWrite(colorBuffer, 4);
 }
 
 void Serial::sendLights(bool on)
 {
+    PLA_TRACE_SCOPE("serial", "Serial::sendLights");
     unsigned char code = on ? 'e' : 'd';
     nativeWrite(&code, 1);
 }
 
 int Serial::getPg()
 {
+    PLA_TRACE_SCOPE("serial", "Serial::getPg");
     unsigned char code = 'p';
     nativeWrite(&code, 1);
     unsigned char buf = 0;
@@ -93,6 +116,7 @@ int Serial::getPg()
 
 void Serial::setPg(unsigned int pg)
 {
+    PLA_TRACE_SCOPE("serial", "Serial::setPg");
     unsigned char buf[2] = {
         'P',
         static_cast<unsigned char>(pg)
@@ -121,8 +145,17 @@ void Serial::nativeRead(unsigned char *array, unsigned int count)
         ReadFile(hComPort, array, count, &read, nullptr);
     }
 #else
-    if (comFd != -1)
-        ::read(comFd, array, count);
+    // Wait for each chunk with a timeout, so that a lost reply cannot hang
+    // the caller
+    pollfd pfd {comFd, POLLIN, 0};
+    auto timeout = static_cast<int>(config::SerialReadTimeout.count());
+    while (comFd != -1 && count > 0 && ::poll(&pfd, 1, timeout) > 0) {
+        auto r = ::read(comFd, array, count);
+        if (r <= 0)
+            break;
+        array += r;
+        count -= static_cast<unsigned int>(r);
+    }
 #endif
 }
 
@@ -176,35 +209,10 @@ std::string Serial::nativeOpen(void)
             ++comIndex;
             auto comIndexEnd = data.find(')', comIndex);
             comName = std::string("\\\\.\\") + data.substr(comIndex, comIndexEnd - comIndex);
-            hComPort = CreateFileA(comName.data(), GENERIC_READ | GENERIC_WRITE,
-                                   0, nullptr,
-                                   OPEN_EXISTING, FILE_FLAG_WRITE_THROUGH, nullptr);
-
-            // TODO could check error with GetLastError()
-            if (hComPort != INVALID_HANDLE_VALUE) {
-                // Set connection parameters to what we need
-                DCB params {};
-                params.DCBlength = sizeof(DCB);
-                GetCommState(hComPort, &params);
-                //params.BaudRate = CBR_9600; // Do not need to specify.
-                params.ByteSize = 8;
-                params.StopBits = ONESTOPBIT;
-                params.Parity = ODDPARITY;
-                SetCommState(hComPort, &params);
-
-                // Send 'i' identification command
-                unsigned char cmd = 'i';
-                nativeWrite(&cmd, 1);
-                char buf[3];
-                nativeRead(reinterpret_cast<unsigned char *>(buf), 3);
-
-                if (strncmp(buf, "PLA", 3) == 0) {
-                    break;
-                } else {
-                    CloseHandle(hComPort);
-                }
-            }
+            if (nativeOpenPort(comName))
+                break;
         }
+        comName.clear();
     }
 
     delete devInfo;
@@ -214,19 +222,63 @@ std::string Serial::nativeOpen(void)
 
     for (char i = '0'; i <= '9'; i++) {
         portBuffer[11] = i;
-        comFd = ::open(portBuffer, O_RDWR | O_NOCTTY | O_SYNC);
-
-        if (comFd != -1) {
-            char buf[3];
-            auto w = ::write(comFd, "i", 1);
-            auto r = ::read(comFd, buf, 3);
-            if (w == 1 && r == 3 && strncmp(buf, "PLA", 3) == 0)
-                break;
-            else
-                ::close(comFd);
-        }
+        if (nativeOpenPort(portBuffer))
+            break;
     }
 
     return connected() ? portBuffer : "";
 #endif
 }
+
+bool Serial::nativeOpenPort(const std::string& port)
+{
+#ifdef PLA_WINDOWS
+    hComPort = CreateFileA(port.data(), GENERIC_READ | GENERIC_WRITE,
+                           0, nullptr,
+                           OPEN_EXISTING, FILE_FLAG_WRITE_THROUGH, nullptr);
+
+    // TODO could check error with GetLastError()
+    if (hComPort == INVALID_HANDLE_VALUE)
+        return false;
+
+    // Set connection parameters to what we need
+    DCB params {};
+    params.DCBlength = sizeof(DCB);
+    GetCommState(hComPort, &params);
+    //params.BaudRate = CBR_9600; // Do not need to specify.
+    params.ByteSize = 8;
+    params.StopBits = ONESTOPBIT;
+    params.Parity = ODDPARITY;
+    SetCommState(hComPort, &params);
+
+    // Send 'i' identification command
+    unsigned char cmd = 'i';
+    nativeWrite(&cmd, 1);
+    char buf[3] = {};
+    nativeRead(reinterpret_cast<unsigned char *>(buf), 3);
+
+    if (strncmp(buf, "PLA", 3) != 0) {
+        CloseHandle(hComPort);
+        hComPort = INVALID_HANDLE_VALUE;
+        return false;
+    }
+
+    return true;
+#else
+    comFd = ::open(port.c_str(), O_RDWR | O_NOCTTY | O_SYNC);
+    if (comFd == -1)
+        return false;
+
+    // Send 'i' identification command
+    char buf[3] = {};
+    auto w = ::write(comFd, "i", 1);
+    nativeRead(reinterpret_cast<unsigned char *>(buf), 3);
+    if (w != 1 || strncmp(buf, "PLA", 3) != 0) {
+        ::close(comFd);
+        comFd = -1;
+        return false;
+    }
+
+    return true;
+#endif
+}
@@ -25,6 +25,14 @@ public:
      */
     static bool open(void);
 
+    /**
+     * Attempts to open a serial connection with the controller on the given
+     * device (e.g. "/dev/ttyACM0", "COM3", or an emulator's PTY).
+     * @param device Path to the serial device
+     * @return true if success
+     */
+    static bool open(const std::string& device);
+
     /**
      * Closes the serial connection to the controller.
      */
@@ -70,6 +78,13 @@ private:
 
     static std::string nativeOpen(void);
 
+    /**
+     * Opens the given port and checks that a controller answers on it.
+     * @param port Path to the serial device
+     * @return true if the controller identified itself
+     */
+    static bool nativeOpenPort(const std::string& port);
+
     static void nativeWrite(unsigned char *array, unsigned int count);
     static void nativeRead(unsigned char *array, unsigned int count);
 
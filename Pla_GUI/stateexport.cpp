@@ -0,0 +1,118 @@
+#include "stateexport.h"
+
+#ifndef PLA_WINDOWS
+#include "pla_state.h"
+
+#include <cstring>
+#include <sys/stat.h>
+#endif
+
+std::atomic<pla_state_shm *> StateExport::segment (nullptr);
+
+#ifdef PLA_WINDOWS
+
+bool StateExport::open(void)
+{
+    return false;
+}
+
+void StateExport::close(void)
+{
+}
+
+void StateExport::publish(const ControllerState&, bool)
+{
+}
+
+#else
+
+bool StateExport::open(void)
+{
+    if (isOpen())
+        return true;
+
+    // Readable by everyone; other processes only ever map it read-only
+    int fd = shm_open(PLA_STATE_SHM_NAME, O_RDWR | O_CREAT, 0644);
+    if (fd == -1)
+        return false;
+
+    if (ftruncate(fd, sizeof(pla_state_shm)) != 0) {
+        ::close(fd);
+        shm_unlink(PLA_STATE_SHM_NAME);
+        return false;
+    }
+
+    void *map = mmap(nullptr, sizeof(pla_state_shm), PROT_READ | PROT_WRITE,
+        MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) {
+        shm_unlink(PLA_STATE_SHM_NAME);
+        return false;
+    }
+
+    // Readers check the magic value last, so it's written after the rest
+    auto shm = static_cast<pla_state_shm *>(map);
+    std::memset(shm, 0, sizeof(pla_state_shm));
+    shm->version = PLA_STATE_VERSION;
+    shm->size = sizeof(pla_state_shm);
+    __atomic_store_n(&shm->magic, PLA_STATE_MAGIC, __ATOMIC_RELEASE);
+
+    segment.store(shm);
+    return true;
+}
+
+void StateExport::close(void)
+{
+    auto shm = segment.exchange(nullptr);
+    if (shm == nullptr)
+        return;
+
+    // Existing readers keep their mapping; new ones won't find the segment
+    shm_unlink(PLA_STATE_SHM_NAME);
+    munmap(shm, sizeof(pla_state_shm));
+}
+
+void StateExport::publish(const ControllerState& state, bool connected)
+{
+    auto shm = segment.load(std::memory_order_relaxed);
+    if (shm == nullptr)
+        return;
+
+    pla_state out {};
+    out.left_x = state.leftX;
+    out.left_y = state.leftY;
+    out.right_x = state.rightX;
+    out.right_y = state.rightY;
+    out.primary_x = state.primaryX;
+    out.primary_y = state.primaryY;
+    out.wheel = state.wheel;
+    out.buttons = state.buttons;
+    out.pg = state.pg;
+    out.left_actions = state.leftActions;
+    out.right_actions = state.rightActions;
+    out.primary_actions = state.primaryActions;
+    out.steering_actions = state.steeringActions;
+    out.timestamp_lo = static_cast<std::uint32_t>(state.timestamp);
+    out.timestamp_hi = static_cast<std::uint32_t>(
+        static_cast<std::uint64_t>(state.timestamp) >> 32);
+    out.frame = shm->state.frame + 1;
+    out.connected = connected ? 1 : 0;
+
+    std::uint32_t words[PLA_STATE_WORDS];
+    static_assert(sizeof(words) == sizeof(pla_state), "pla_state must be all words");
+    std::memcpy(words, &out, sizeof(words));
+
+    // Same protocol as Seqlock, spelled out over the shared words so C
+    // readers can follow it (see pla_state_read())
+    auto dst = reinterpret_cast<std::uint32_t *>(&shm->state);
+    auto seq = __atomic_load_n(&shm->sequence, __ATOMIC_RELAXED);
+    __atomic_store_n(&shm->sequence, seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    for (unsigned int i = 0; i < PLA_STATE_WORDS; i++)
+        __atomic_store_n(&dst[i], words[i], __ATOMIC_RELAXED);
+
+    __atomic_store_n(&shm->sequence, seq + 2, __ATOMIC_RELEASE);
+}
+
+#endif // PLA_WINDOWS
@@ -0,0 +1,51 @@
+/**
+ * @file stateexport.h
+ * @brief Exports live controller state to other processes.
+ */
+#ifndef STATEEXPORT_H
+#define STATEEXPORT_H
+
+#include "controllerstate.h"
+
+#include <atomic>
+
+struct pla_state_shm;
+
+/**
+ * @class StateExport
+ * @brief Mirrors each input frame into a POSIX shared-memory segment, laid
+ * out as described in pla_state.h.
+ *
+ * Export is off until open() is called. publish() must only be called from
+ * the controller thread; open() and close() must not race with it.
+ */
+class StateExport
+{
+public:
+    /**
+     * Creates the shared-memory segment.
+     * @return True if success (always false on Windows)
+     */
+    static bool open(void);
+
+    /**
+     * Removes the shared-memory segment.
+     */
+    static void close(void);
+
+    /**
+     * Writes a frame to the segment, if exporting.
+     * @param state The frame to write
+     * @param connected True if the frame came from a connected controller
+     */
+    static void publish(const ControllerState& state, bool connected);
+
+    inline static bool isOpen(void) {
+        return segment.load(std::memory_order_relaxed) != nullptr;
+    }
+
+private:
+    static std::atomic<pla_state_shm *> segment;
+};
+
+#endif // STATEEXPORT_H
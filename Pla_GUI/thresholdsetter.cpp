@@ -5,12 +5,11 @@
 #include "profile.h"
 
 #include <QApplication>
-#include <QtConcurrent/QtConcurrent>
-#include <QPainter>
+#include <QScreen>
 
+#include <algorithm>
 #include <atomic>
-#include <chrono>
-using namespace std::chrono_literals;
+#include <cmath>
 
 constexpr int mapSize = 90;
 static std::atomic<JoystickTracker *> currentJoy (nullptr);
@@ -34,9 +33,8 @@ ThresholdSetter::ThresholdSetter(QWidget *parent, QWidget *mainwindow) :
     //currentPrimary(this),
     configSave("SAVE", this),
     configSaveAll("SAVE ALL", this),
-    joyMap(mapSize, mapSize, QImage::Format_ARGB32),
-    joyMapLabel(this),
-    shouldUpdate(false)
+    joyMap(this),
+    refreshTimer(this)
 {
     setWindowTitle("Trigger Settings");
     setFixedSize(340, 300);
@@ -44,7 +42,7 @@ ThresholdSetter::ThresholdSetter(QWidget *parent, QWidget *mainwindow) :
 
     // Set geometries
     lCurrentPosition.setGeometry(20, 10, 180, 20);
-    joyMapLabel.setGeometry(20, 30, mapSize, mapSize);
+    joyMap.setGeometry(20, 30, mapSize, mapSize);
     lInstruction.setGeometry(30 + mapSize, 30, 210, mapSize);
     lShortThresh.setGeometry(20, 130, 300, 20);
     shortThreshold.setGeometry(20, 150, 300, 10);
@@ -77,13 +75,12 @@ ThresholdSetter::ThresholdSetter(QWidget *parent, QWidget *mainwindow) :
     connect(&shortThreshold, SIGNAL(valueChanged(int)), this, SLOT(onThresholdsChanged(int)));
     connect(&farThreshold, SIGNAL(valueChanged(int)), this, SLOT(onThresholdsChanged(int)));
     connect(&primaryWidth, SIGNAL(valueChanged(int)), this, SLOT(onPrimaryWidthChanged(int)));
+    connect(&refreshTimer, SIGNAL(timeout()), this, SLOT(updateMap()));
     connect(mainwindow, SIGNAL(exitingProgram()), this, SLOT(close()));
 }
 
 void ThresholdSetter::showEvent(QShowEvent *event)
 {
-    shouldUpdate.store(true);
-
     auto name = joyName.load();
     auto nameL = name ? name[0] : 'P';
     auto joy = nameL == 'L' ? &Controller::Left
@@ -93,21 +90,22 @@ void ThresholdSetter::showEvent(QShowEvent *event)
     farThreshold.setValue(joy->getFarThreshold());
     currentJoy.store(joy);
     primaryWidth.setValue(std::round(joy->getPrimaryAngle() * 100));
+    joyMap.setThresholds(shortThreshold.value(), farThreshold.value());
+    joyMap.setPrimaryAngle(joy->getPrimaryAngle());
 
-    // Start the joystick monitoring thread
+    // Keep reading the joystick, but don't fire its actions
     installEventFilter(this);
-    joyThread = QThread::create([this] {
-        Controller::setEnabled(true);
-        Controller::setOperating(false);
-        while (shouldUpdate.load()) {
-            joyPosition = currentJoy.load()->getPosition();
-            updateMap();
-            QThread::msleep(50);
-        }
-        Controller::setOperating(true);
-        Controller::setEnabled(false);
-    });
-    joyThread->start();
+    Controller::setEnabled(true);
+    Controller::setOperating(false);
+
+    // Redraw the position once per display refresh; without a screen, or
+    // with an unknown rate, assume 60 Hz
+    auto screen = QGuiApplication::primaryScreen();
+    auto refreshRate = screen != nullptr ? screen->refreshRate() : 0;
+    if (refreshRate <= 0)
+        refreshRate = 60;
+    refreshTimer.setTimerType(Qt::PreciseTimer);
+    refreshTimer.start(std::max(1, static_cast<int>(1000 / refreshRate)));
 
     if (event != nullptr)
         event->accept();
@@ -115,10 +113,10 @@ void ThresholdSetter::showEvent(QShowEvent *event)
 
 void ThresholdSetter::hideEvent(QHideEvent *event)
 {
-    // Bring back the monitor thread
-    shouldUpdate.store(false);
-    joyThread->wait();
-    joyThread->terminate();
+    // Stop monitoring
+    refreshTimer.stop();
+    Controller::setOperating(true);
+    Controller::setEnabled(false);
     removeEventFilter(this);
     if (event != nullptr)
         event->accept();
@@ -146,6 +144,8 @@ void ThresholdSetter::onThresholdsChanged(int)
     int sval = shortThreshold.value();
     if (farThreshold.value() - sval < 1000)
         farThreshold.setValue(sval + 1000);
+
+    joyMap.setThresholds(sval, farThreshold.value());
 }
 
 void ThresholdSetter::onPrimaryWidthChanged(int value)
@@ -154,10 +154,7 @@ void ThresholdSetter::onPrimaryWidthChanged(int value)
     if (joy) {
         double angle = value / 100.;
         joy->setPrimaryAngle(angle);
-
-        auto offset = std::tan(angle / 2.) / 2.;
-        mapLineDivs.first = static_cast<int>(std::round((0.5 - offset) * mapSize));
-        mapLineDivs.second = static_cast<int>(std::round((0.5 + offset) * mapSize));
+        joyMap.setPrimaryAngle(angle);
     }
 }
 
@@ -178,44 +175,18 @@ void ThresholdSetter::setJoystick(QString _name)
 
 void ThresholdSetter::updateMap(void)
 {
-    QPainter pen (&joyMap);
-    QPen linePen;
-    long double dist = sqrt(static_cast<long double>(joyPosition.first * joyPosition.first) +
-        static_cast<long double>(joyPosition.second * joyPosition.second));
-    auto rf = farThreshold.value() / 32767. * static_cast<double>(mapSize / 2.);
-    auto rs = shortThreshold.value() / 32767. * static_cast<double>(mapSize / 2.);
-
-    pen.fillRect(0, 0, mapSize, mapSize, dist > farThreshold.value() ? Qt::red : Qt::black);
-    linePen.setWidth(2);
-    linePen.setColor(Qt::white);
-    pen.setPen(linePen);
-    pen.drawRect(0, 0, mapSize, mapSize);
-
-    linePen.setColor(Qt::red);
-    pen.setBrush(dist > shortThreshold.value() && dist < farThreshold.value() ?
-        Qt::green : Qt::black);
-    pen.setPen(linePen);
-    pen.drawEllipse(QPointF(mapSize / 2, mapSize / 2), rf, rf);
-
-    linePen.setColor(Qt::green);
-    pen.setBrush(Qt::black);
-    pen.setPen(linePen);
-    pen.drawEllipse(QPointF(mapSize / 2, mapSize / 2), rs, rs);
-
-    pen.setPen(Qt::gray);
-    pen.setBrush(Qt::gray);
-
-    pen.drawLine(0, mapLineDivs.second, mapSize, mapLineDivs.first);
-    pen.drawLine(0, mapLineDivs.first, mapSize, mapLineDivs.second);
-    pen.drawLine(mapLineDivs.first, 0, mapLineDivs.second, mapSize);
-    pen.drawLine(mapLineDivs.first, mapSize, mapLineDivs.second, 0);
-
-    pen.setPen(Qt::white);
-    pen.setBrush(Qt::white);
-    pen.drawEllipse(QPointF((joyPosition.first + 32767) / 65536. * static_cast<double>(mapSize),
-        mapSize - ((joyPosition.second + 32767) / 65536. * static_cast<double>(mapSize))), 3, 3);
-
-    joyMapLabel.setPixmap(QPixmap::fromImage(joyMap));
+    auto state = Controller::snapshot();
+    switch (joyName.load()[0]) {
+    case 'L':
+        joyMap.setPosition(state.leftX, state.leftY);
+        break;
+    case 'R':
+        joyMap.setPosition(state.rightX, state.rightY);
+        break;
+    default:
+        joyMap.setPosition(state.primaryX, state.primaryY);
+        break;
+    }
 }
 
 void ThresholdSetter::saveSettings(void)
@@ -6,6 +6,7 @@
 #define THRESHOLDSETTER_H
 
 #include "input/joysticktracker.h"
+#include "joystickmap.h"
 
 #include <QDialog>
 #include <QHideEvent>
@@ -14,10 +15,9 @@
 #include <QSettings>
 #include <QShowEvent>
 #include <QSlider>
-#include <QThread>
+#include <QTimer>
 
 #include <atomic>
-#include <thread>
 
 /**
  * @class ThresholdSetter
@@ -54,24 +54,24 @@ private slots:
     void onPrimaryWidthChanged(int);
     void onThresholdsChanged(int);
 
+    /**
+     * Updates the joystick position map, once per display refresh.
+     */
+    void updateMap(void);
+
 public:
     /**
-     * Starts the primary joystick monitoring thread, to provide a sense of
-     * the joystick's range.
+     * Starts monitoring the joystick, to provide a sense of the joystick's
+     * range.
      */
     void showEvent(QShowEvent *) override;
 
     /**
-     * Ends the monitoring thread.
+     * Stops monitoring the joystick.
      */
     void hideEvent(QHideEvent *event) override;
 
 private:
-    /**
-     * Updates the joystick position map.
-     */
-    void updateMap(void);
-
     std::atomic<const char *> joyName;
 
     QLabel lShortThresh;
@@ -86,14 +86,9 @@ private:
 
     QPushButton configSave;
     QPushButton configSaveAll;
-    QImage joyMap;
-    QLabel joyMapLabel;
-
-    std::thread updateCurrent;
-    std::pair<int, int> joyPosition;
-    std::atomic_bool shouldUpdate;
-    QThread *joyThread;
-    std::pair<int, int> mapLineDivs;
+    JoystickMap joyMap;
+
+    QTimer refreshTimer;
 };
 
 #endif // THRESHOLDSETTER_H
@@ -0,0 +1,164 @@
+#include "emulator.h"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <termios.h>
+#include <unistd.h>
+
+ControllerEmulator::ControllerEmulator(Options opts) :
+    options(opts),
+    running(false),
+    pg(0),
+    lights(false),
+    color(0),
+    random(opts.seed)
+{
+
+}
+
+ControllerEmulator::~ControllerEmulator(void)
+{
+    stop();
+}
+
+bool ControllerEmulator::start(void)
+{
+    masterFd = posix_openpt(O_RDWR | O_NOCTTY);
+    if (masterFd == -1)
+        return false;
+
+    if (grantpt(masterFd) != 0 || unlockpt(masterFd) != 0) {
+        stop();
+        return false;
+    }
+
+    slavePath = ptsname(masterFd);
+
+    // Hold the slave side open in raw mode. This keeps the terminal from
+    // echoing or line-buffering the protocol's binary bytes, and keeps the
+    // master readable while Serial opens and closes the device.
+    slaveFd = ::open(slavePath.c_str(), O_RDWR | O_NOCTTY);
+    if (slaveFd == -1) {
+        stop();
+        return false;
+    }
+
+    termios tio {};
+    tcgetattr(slaveFd, &tio);
+    cfmakeraw(&tio);
+    tcsetattr(slaveFd, TCSANOW, &tio);
+
+    running.store(true);
+    worker = std::thread([this] { run(); });
+    return true;
+}
+
+void ControllerEmulator::stop(void)
+{
+    running.store(false);
+    if (worker.joinable())
+        worker.join();
+
+    if (slaveFd != -1) {
+        ::close(slaveFd);
+        slaveFd = -1;
+    }
+    if (masterFd != -1) {
+        ::close(masterFd);
+        masterFd = -1;
+    }
+}
+
+ControllerEmulator::Stats ControllerEmulator::stats(void) const
+{
+    std::lock_guard<std::mutex> guard (statsLock);
+    return counters;
+}
+
+bool ControllerEmulator::readArgs(unsigned char *buf, unsigned int count)
+{
+    pollfd pfd {masterFd, POLLIN, 0};
+    while (count > 0) {
+        if (::poll(&pfd, 1, 500) <= 0)
+            return false;
+        auto r = ::read(masterFd, buf, count);
+        if (r <= 0)
+            return false;
+        buf += r;
+        count -= static_cast<unsigned int>(r);
+    }
+
+    return true;
+}
+
+void ControllerEmulator::reply(const void *data, unsigned int count)
+{
+    auto w = ::write(masterFd, data, count);
+    (void)w;
+}
+
+void ControllerEmulator::run(void)
+{
+    std::uniform_real_distribution<double> chance (0, 1);
+    pollfd pfd {masterFd, POLLIN, 0};
+
+    while (running.load()) {
+        // Wake up regularly to check if we should stop
+        if (::poll(&pfd, 1, 100) <= 0)
+            continue;
+
+        unsigned char cmd;
+        if (::read(masterFd, &cmd, 1) != 1)
+            continue;
+
+        // Arguments are always consumed, even for dropped commands, so the
+        // stream stays in sync
+        unsigned char args[3] = {};
+        bool complete = true;
+        if (cmd == 'c')
+            complete = readArgs(args, 3);
+        else if (cmd == 'P')
+            complete = readArgs(args, 1);
+
+        if (options.delay.count() > 0)
+            std::this_thread::sleep_for(options.delay);
+
+        std::lock_guard<std::mutex> guard (statsLock);
+        if (!complete || (options.dropRate > 0 && chance(random) < options.dropRate)) {
+            counters.dropped++;
+            continue;
+        }
+
+        switch (cmd) {
+        case 'i':
+            counters.identify++;
+            reply("PLA", 3);
+            break;
+        case 'c':
+            counters.color++;
+            color.store((args[0] << 16) | (args[1] << 8) | args[2]);
+            break;
+        case 'e':
+        case 'd':
+            counters.lights++;
+            lights.store(cmd == 'e');
+            break;
+        case 'p':
+        {
+            counters.getPg++;
+            unsigned char current = pg.load();
+            reply(&current, 1);
+            break;
+        }
+        case 'P':
+            counters.setPg++;
+            if (args[0] < 8)
+                pg.store(args[0]);
+            break;
+        default:
+            counters.unknown++;
+            break;
+        }
+    }
+}
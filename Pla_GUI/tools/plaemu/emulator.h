@@ -0,0 +1,116 @@
+/**
+ * @file emulator.h
+ * @brief Software stand-in for the controller's serial firmware.
+ */
+#ifndef EMULATOR_H
+#define EMULATOR_H
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+
+/**
+ * @class ControllerEmulator
+ * @brief Creates a pseudo-terminal that answers the controller's serial
+ * protocol, so Serial can be exercised without PLA hardware.
+ *
+ * Supported commands:
+ *     'i'          Replies "PLA"
+ *     'c' r g b    Sets the LED color
+ *     'e' / 'd'    Enables/disables the user lights
+ *     'p'          Replies with the current PG as one byte
+ *     'P' pg       Sets the current PG
+ *
+ * Replies can be delayed and commands can be dropped at random, to mimic a
+ * slow or lossy link.
+ */
+class ControllerEmulator
+{
+public:
+    struct Options {
+        // Delay before each command is handled
+        std::chrono::microseconds delay {0};
+        // Chance (0-1) that a received command is ignored
+        double dropRate = 0;
+        // Seed for the drop generator, for repeatable runs
+        unsigned int seed = 1;
+    };
+
+    struct Stats {
+        unsigned long identify = 0;
+        unsigned long color = 0;
+        unsigned long lights = 0;
+        unsigned long getPg = 0;
+        unsigned long setPg = 0;
+        unsigned long dropped = 0;
+        unsigned long unknown = 0;
+    };
+
+    explicit ControllerEmulator(Options opts);
+    ~ControllerEmulator(void);
+
+    ControllerEmulator(const ControllerEmulator&) = delete;
+    ControllerEmulator& operator=(const ControllerEmulator&) = delete;
+
+    /**
+     * Creates the pseudo-terminal and starts answering commands.
+     * @return True if success
+     */
+    bool start(void);
+
+    /**
+     * Stops the emulator and closes the pseudo-terminal.
+     */
+    void stop(void);
+
+    /**
+     * Gets the path that Serial should open (e.g. "/dev/pts/3").
+     */
+    const std::string& devicePath(void) const
+    { return slavePath; }
+
+    /**
+     * Gets a copy of the command counters.
+     */
+    Stats stats(void) const;
+
+    unsigned char getPg(void) const
+    { return pg.load(); }
+    bool getLights(void) const
+    { return lights.load(); }
+    unsigned int getColor(void) const
+    { return color.load(); }
+
+private:
+    Options options;
+
+    int masterFd = -1;
+    int slaveFd = -1;
+    std::string slavePath;
+
+    std::atomic_bool running;
+    std::thread worker;
+
+    mutable std::mutex statsLock;
+    Stats counters;
+
+    std::atomic<unsigned char> pg;
+    std::atomic_bool lights;
+    std::atomic<unsigned int> color;
+
+    std::minstd_rand random;
+
+    void run(void);
+
+    /**
+     * Reads exactly count bytes, giving up after the firmware's 500ms
+     * argument timeout.
+     */
+    bool readArgs(unsigned char *buf, unsigned int count);
+    void reply(const void *data, unsigned int count);
+};
+
+#endif // EMULATOR_H
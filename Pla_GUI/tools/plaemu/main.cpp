@@ -0,0 +1,62 @@
+/**
+ * @file main.cpp
+ * @brief Stand-alone controller emulator.
+ *
+ * Usage: plaemu [--delay-us N] [--drop RATE] [--seed N]
+ *
+ * Prints the pseudo-terminal path to connect to, then answers commands until
+ * interrupted. Command counters are printed on exit.
+ */
+#include "emulator.h"
+
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+static volatile std::sig_atomic_t quit = 0;
+
+int main(int argc, char *argv[])
+{
+    ControllerEmulator::Options opts;
+
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (hasValue && std::strcmp(argv[i], "--delay-us") == 0) {
+            opts.delay = std::chrono::microseconds(std::atol(argv[++i]));
+        } else if (hasValue && std::strcmp(argv[i], "--drop") == 0) {
+            opts.dropRate = std::atof(argv[++i]);
+        } else if (hasValue && std::strcmp(argv[i], "--seed") == 0) {
+            opts.seed = static_cast<unsigned int>(std::atol(argv[++i]));
+        } else {
+            std::cerr << "Usage: " << argv[0]
+                << " [--delay-us N] [--drop RATE] [--seed N]" << std::endl;
+            return 1;
+        }
+    }
+
+    ControllerEmulator emulator (opts);
+    if (!emulator.start()) {
+        std::cerr << "Unable to create a pseudo-terminal." << std::endl;
+        return 1;
+    }
+
+    std::cout << emulator.devicePath() << std::endl;
+
+    std::signal(SIGINT, [](int) { quit = 1; });
+    std::signal(SIGTERM, [](int) { quit = 1; });
+    while (!quit)
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    emulator.stop();
+
+    auto s = emulator.stats();
+    std::cout << "identify " << s.identify << "\n"
+              << "color " << s.color << "\n"
+              << "lights " << s.lights << "\n"
+              << "getpg " << s.getPg << "\n"
+              << "setpg " << s.setPg << "\n"
+              << "dropped " << s.dropped << "\n"
+              << "unknown " << s.unknown << std::endl;
+    return 0;
+}
@@ -0,0 +1,20 @@
+#-------------------------------------------------
+#
+# Controller firmware emulator (Linux pseudo-terminal)
+#
+#-------------------------------------------------
+
+TARGET = plaemu
+TEMPLATE = app
+
+CONFIG += console c++14 thread
+CONFIG -= qt app_bundle
+
+SOURCES += \
+    emulator.cpp \
+    main.cpp
+
+HEADERS += \
+    emulator.h
+
+QMAKE_CXXFLAGS += -Wall -Wextra -pedantic
@@ -0,0 +1,278 @@
+/**
+ * @file main.cpp
+ * @brief Measures the input engine's latency from controller frame to
+ * delivered X key event.
+ *
+ * Usage: plalatency [--scenario sweep|macro] [--duration S] [--rate HZ]
+ *                   [--display :N] [--no-xvfb]
+ *
+ * Starts Xvfb on the given display (default :99) unless --no-xvfb is given,
+ * in which case the display must already exist. Synthetic frames are fed to
+ * Controller::process(), keystrokes are sent through the normal libxdo path,
+ * and XRecord reports when the X server handled each one.
+ *
+ * Results are printed one per line as "name value unit".
+ */
+#include "controller.h"
+#include "keybackend.h"
+#include "latency.h"
+#include "macro.h"
+#include "syntheticinputsource.h"
+#include "xrecorder.h"
+
+#include <QCoreApplication>
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <mutex>
+
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @class ProbeKeyBackend
+ * @brief Passes keystrokes to the native backend, remembering which input
+ * frame caused each one so XRecord's reports can be matched up in order.
+ */
+class ProbeKeyBackend : public KeyBackend
+{
+public:
+    void send(int key, Qt::KeyboardModifiers mod, bool press) override {
+        {
+            std::lock_guard<std::mutex> guard (lock);
+            pending.push_back({frameTime, press});
+            sent++;
+        }
+        native.send(key, mod, press);
+    }
+
+    void setFrameTime(std::int64_t timestamp) {
+        std::lock_guard<std::mutex> guard (lock);
+        frameTime = timestamp;
+    }
+
+    /**
+     * Called by XRecorder for each key event the server handled.
+     */
+    void delivered(bool press, Clock::time_point when) {
+        std::lock_guard<std::mutex> guard (lock);
+        if (pending.empty()) {
+            unmatched++;
+            return;
+        }
+
+        auto p = pending.front();
+        pending.pop_front();
+        if (p.press != press)
+            mismatched++;
+
+        auto at = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            when.time_since_epoch()).count();
+        latency.record(at - p.frameTime);
+        received++;
+    }
+
+    LatencyHistogram latency;
+    unsigned long sent = 0;
+    unsigned long received = 0;
+    unsigned long unmatched = 0;
+    unsigned long mismatched = 0;
+
+private:
+    struct Pending {
+        std::int64_t frameTime;
+        bool press;
+    };
+
+    NativeKeyBackend native;
+    std::mutex lock;
+    std::deque<Pending> pending;
+    std::int64_t frameTime = 0;
+};
+
+/**
+ * Starts Xvfb and waits for it to accept connections.
+ * @return Xvfb's pid, or -1 on failure
+ */
+static pid_t startXvfb(const std::string& display)
+{
+    pid_t pid = fork();
+    if (pid == 0) {
+        execlp("Xvfb", "Xvfb", display.c_str(), "-nolisten", "tcp",
+            "-screen", "0", "640x480x24", static_cast<char *>(nullptr));
+        _exit(127);
+    } else if (pid < 0) {
+        return -1;
+    }
+
+    auto deadline = Clock::now() + std::chrono::seconds(5);
+    while (Clock::now() < deadline) {
+        if (waitpid(pid, nullptr, WNOHANG) == pid)
+            return -1;
+
+        if (XRecorder::canConnect(display))
+            return pid;
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+
+    kill(pid, SIGTERM);
+    waitpid(pid, nullptr, 0);
+    return -1;
+}
+
+/**
+ * Binds keys that libxdo can type without adding modifier events, so each
+ * keystroke sent is exactly one X event.
+ */
+static void bindKeys(KeySender& sender, int offset)
+{
+    static const int keys[] = {
+        Qt::Key_0, Qt::Key_1, Qt::Key_2, Qt::Key_3, Qt::Key_4, Qt::Key_5,
+        Qt::Key_6, Qt::Key_7, Qt::Key_8, Qt::Key_9, Qt::Key_F1, Qt::Key_F2,
+        Qt::Key_F3, Qt::Key_F4, Qt::Key_F5, Qt::Key_F6, Qt::Key_F7, Qt::Key_F8,
+        Qt::Key_F9, Qt::Key_F10, Qt::Key_F11, Qt::Key_F12, Qt::Key_Tab,
+        Qt::Key_Return, Qt::Key_Space, Qt::Key_Up, Qt::Key_Down, Qt::Key_Left,
+        Qt::Key_Right
+    };
+    constexpr int Count = sizeof(keys) / sizeof(keys[0]);
+
+    for (int i = 0; i < 16; i++)
+        sender.setKey(i, keys[(i + offset) % Count]);
+}
+
+static void printLatency(const char *name, const LatencyHistogram& h)
+{
+    std::cout << name << "_p50 " << h.quantile(0.5) / 1000. << " us\n"
+              << name << "_p99 " << h.quantile(0.99) / 1000. << " us\n"
+              << name << "_max " << h.max() / 1000. << " us\n";
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app (argc, argv);
+
+    auto pattern = SyntheticInputSource::DiagonalSweep;
+    int seconds = 10;
+    int rate = 100;
+    std::string display = ":99";
+    bool useXvfb = true;
+
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (hasValue && std::strcmp(argv[i], "--scenario") == 0) {
+            i++;
+            if (std::strcmp(argv[i], "macro") == 0)
+                pattern = SyntheticInputSource::MacroStorm;
+        } else if (hasValue && std::strcmp(argv[i], "--duration") == 0) {
+            seconds = std::max(1, std::atoi(argv[++i]));
+        } else if (hasValue && std::strcmp(argv[i], "--rate") == 0) {
+            rate = std::max(1, std::atoi(argv[++i]));
+        } else if (hasValue && std::strcmp(argv[i], "--display") == 0) {
+            display = argv[++i];
+        } else if (std::strcmp(argv[i], "--no-xvfb") == 0) {
+            useXvfb = false;
+            auto env = std::getenv("DISPLAY");
+            if (env != nullptr)
+                display = env;
+        } else {
+            std::cerr << "Usage: " << argv[0]
+                << " [--scenario sweep|macro] [--duration S] [--rate HZ]"
+                   " [--display :N] [--no-xvfb]" << std::endl;
+            return 1;
+        }
+    }
+
+    pid_t xvfb = -1;
+    if (useXvfb) {
+        xvfb = startXvfb(display);
+        if (xvfb == -1) {
+            std::cerr << "Unable to start Xvfb on " << display << std::endl;
+            return 1;
+        }
+    }
+
+    // libxdo connects to $DISPLAY on first use
+    setenv("DISPLAY", display.c_str(), 1);
+
+    ProbeKeyBackend probe;
+    XRecorder recorder;
+    bool recording = recorder.start(display,
+        [&probe](unsigned int, bool press, Clock::time_point when) {
+            probe.delivered(press, when);
+        });
+    if (!recording) {
+        std::cerr << "XRecord is not available on " << display << std::endl;
+        if (xvfb != -1) {
+            kill(xvfb, SIGTERM);
+            waitpid(xvfb, nullptr, 0);
+        }
+        return 1;
+    }
+
+    // Set up the trackers as a profile would
+    for (auto tracker : {&Controller::Left, &Controller::Right, &Controller::Primary.getPG(0)})
+        tracker->setDiagonals(true);
+    bindKeys(Controller::Left, 0);
+    bindKeys(Controller::Right, 10);
+    if (pattern == SyntheticInputSource::MacroStorm) {
+        auto& storm = Macro::get("storm");
+        for (int k = Qt::Key_1; k <= Qt::Key_4; k++) {
+            storm.emplace_back(Key(k), true);
+            storm.emplace_back(Key(k), false);
+        }
+        for (int i = 0; i < 16; i++)
+            Controller::Primary.getPG(0).setKey(i, std::string("storm"));
+    } else {
+        bindKeys(Controller::Primary.getPG(0), 20);
+    }
+
+    KeyBackend::setCurrent(&probe);
+
+    auto period = std::chrono::nanoseconds(1000000000 / rate);
+    SyntheticInputSource source (pattern, period, std::chrono::seconds(seconds));
+    InputFrame frame;
+    auto start = Clock::now();
+    while (source.read(frame)) {
+        probe.setFrameTime(frame.timestamp);
+        Controller::process(frame);
+    }
+
+    // Center everything so all keys are released
+    frame = {};
+    frame.timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        Clock::now().time_since_epoch()).count();
+    probe.setFrameTime(frame.timestamp);
+    Controller::process(frame);
+    Controller::process(frame);
+    KeySender::finishMacros();
+    auto elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+    // Let the last events arrive
+    std::this_thread::sleep_for(std::chrono::milliseconds(250));
+    recorder.stop();
+    KeySender::stopMacros();
+    KeyBackend::setCurrent(nullptr);
+
+    if (xvfb != -1) {
+        kill(xvfb, SIGTERM);
+        waitpid(xvfb, nullptr, 0);
+    }
+
+    std::cout << "frames " << source.frames() << " count\n"
+              << "frame_rate " << source.frames() / elapsed << " frames/s\n"
+              << "late_frames " << source.lateFrames() << " count\n"
+              << "keys_sent " << probe.sent << " count\n"
+              << "keys_delivered " << probe.received << " count\n"
+              << "key_rate " << probe.received / elapsed << " keys/s\n"
+              << "keys_unmatched " << probe.unmatched << " count\n"
+              << "keys_mismatched " << probe.mismatched << " count\n";
+    printLatency("frame_to_key", probe.latency);
+    std::cout.flush();
+    return 0;
+}
@@ -0,0 +1,28 @@
+#-------------------------------------------------
+#
+# End-to-end latency harness (Xvfb + XRecord)
+#
+#-------------------------------------------------
+
+QT += core gui concurrent
+
+TARGET = plalatency
+TEMPLATE = app
+
+CONFIG += console c++14 thread
+CONFIG -= app_bundle
+
+include(../../engine.pri)
+
+SOURCES += \
+    main.cpp \
+    syntheticinputsource.cpp \
+    xrecorder.cpp
+
+HEADERS += \
+    syntheticinputsource.h \
+    xrecorder.h
+
+LIBS += -lX11 -lXtst
+
+QMAKE_CXXFLAGS += -Wall -Wextra -pedantic
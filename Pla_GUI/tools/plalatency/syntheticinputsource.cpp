@@ -0,0 +1,62 @@
+#include "syntheticinputsource.h"
+
+#include <cmath>
+#include <thread>
+
+SyntheticInputSource::SyntheticInputSource(Pattern p, std::chrono::nanoseconds per,
+    std::chrono::nanoseconds dur) :
+    pattern(p),
+    period(per),
+    duration(dur)
+{
+
+}
+
+bool SyntheticInputSource::read(InputFrame& frame)
+{
+    auto now = std::chrono::steady_clock::now();
+    if (count == 0) {
+        start = now;
+        deadline = now;
+    } else {
+        deadline += period;
+        if (now > deadline + period)
+            late++;
+        else
+            std::this_thread::sleep_until(deadline);
+    }
+
+    if (deadline - start >= duration)
+        return false;
+
+    frame = {};
+    frame.timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+
+    auto step = count / 2;
+    if (pattern == DiagonalSweep) {
+        // Eight directions and the center, near ring then far ring
+        auto direction = step % 9;
+        auto radius = (step / 9) % 2 ? 31000. : 25000.;
+        std::int16_t x = 0, y = 0;
+        if (direction < 8) {
+            auto angle = direction * M_PI / 4;
+            x = static_cast<std::int16_t>(radius * std::cos(angle));
+            y = static_cast<std::int16_t>(radius * std::sin(angle));
+        }
+
+        // Primary (0, 1), right (2, 5) and left (3, 4)
+        frame.axes[0] = x;
+        frame.axes[1] = y;
+        frame.axes[2] = y;
+        frame.axes[5] = x;
+        frame.axes[3] = -x;
+        frame.axes[4] = -y;
+    } else {
+        // Up, then back to the center
+        frame.axes[1] = step % 2 ? 0 : -31000;
+    }
+
+    count++;
+    return true;
+}
@@ -0,0 +1,62 @@
+/**
+ * @file syntheticinputsource.h
+ * @brief Generates controller input frames for load and latency tests.
+ */
+#ifndef SYNTHETICINPUTSOURCE_H
+#define SYNTHETICINPUTSOURCE_H
+
+#include "inputsource.h"
+
+#include <chrono>
+
+/**
+ * @class SyntheticInputSource
+ * @brief Produces frames at a fixed rate, following a scripted pattern.
+ *
+ * Each position is held for two frames, giving the trackers' input filter
+ * time to settle on it.
+ */
+class SyntheticInputSource : public InputSource
+{
+public:
+    enum Pattern {
+        // All three sticks step around the eight directions, alternating
+        // between the near and far rings
+        DiagonalSweep,
+        // The primary stick flicks up and back, to fire a bound macro
+        MacroStorm
+    };
+
+    SyntheticInputSource(Pattern pattern, std::chrono::nanoseconds period,
+        std::chrono::nanoseconds duration);
+
+    /**
+     * Waits for the next frame's deadline, then makes the frame.
+     * @return False once the duration has passed
+     */
+    bool read(InputFrame& frame) override;
+
+    unsigned long frames(void) const {
+        return count;
+    }
+
+    /**
+     * Gets how many frames were asked for after their deadline had already
+     * passed by more than a period (i.e. the engine couldn't keep up).
+     */
+    unsigned long lateFrames(void) const {
+        return late;
+    }
+
+private:
+    Pattern pattern;
+    std::chrono::nanoseconds period;
+    std::chrono::nanoseconds duration;
+
+    std::chrono::steady_clock::time_point start;
+    std::chrono::steady_clock::time_point deadline;
+    unsigned long count = 0;
+    unsigned long late = 0;
+};
+
+#endif // SYNTHETICINPUTSOURCE_H
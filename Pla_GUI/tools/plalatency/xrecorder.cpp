@@ -0,0 +1,97 @@
+#include "xrecorder.h"
+
+#include <X11/Xlib.h>
+#include <X11/Xproto.h>
+#include <X11/extensions/record.h>
+
+XRecorder::~XRecorder(void)
+{
+    stop();
+}
+
+bool XRecorder::start(const std::string& display, Callback fn)
+{
+    stop();
+
+    // Recording needs two connections: one blocks delivering events, the
+    // other controls the context
+    control = XOpenDisplay(display.c_str());
+    data = XOpenDisplay(display.c_str());
+    if (control == nullptr || data == nullptr) {
+        stop();
+        return false;
+    }
+
+    int major, minor;
+    if (!XRecordQueryVersion(control, &major, &minor)) {
+        stop();
+        return false;
+    }
+
+    auto range = XRecordAllocRange();
+    range->device_events.first = KeyPress;
+    range->device_events.last = KeyRelease;
+    XRecordClientSpec clients = XRecordAllClients;
+    context = XRecordCreateContext(control, 0, &clients, 1, &range, 1);
+    XFree(range);
+    if (context == 0) {
+        stop();
+        return false;
+    }
+
+    // The context must exist on the server before the data connection uses it
+    XSync(control, False);
+
+    XRecordInterceptProc intercept = [](XPointer self, XRecordInterceptData *record) {
+        auto when = std::chrono::steady_clock::now();
+        auto recorder = reinterpret_cast<XRecorder *>(self);
+
+        if (record->category == XRecordFromServer && record->data_len > 0) {
+            auto type = record->data[0] & 0x7F;
+            auto keycode = record->data[1];
+            if (type == KeyPress || type == KeyRelease)
+                recorder->callback(keycode, type == KeyPress, when);
+        }
+
+        XRecordFreeData(record);
+    };
+
+    callback = fn;
+    worker = std::thread([this, intercept] {
+        XRecordEnableContext(data, context, intercept, reinterpret_cast<XPointer>(this));
+    });
+    return true;
+}
+
+void XRecorder::stop(void)
+{
+    if (context != 0) {
+        XRecordDisableContext(control, context);
+        XSync(control, False);
+    }
+    if (worker.joinable())
+        worker.join();
+
+    if (context != 0) {
+        XRecordFreeContext(control, context);
+        context = 0;
+    }
+    if (data != nullptr) {
+        XCloseDisplay(data);
+        data = nullptr;
+    }
+    if (control != nullptr) {
+        XCloseDisplay(control);
+        control = nullptr;
+    }
+}
+
+bool XRecorder::canConnect(const std::string& display)
+{
+    auto dpy = XOpenDisplay(display.c_str());
+    if (dpy == nullptr)
+        return false;
+
+    XCloseDisplay(dpy);
+    return true;
+}
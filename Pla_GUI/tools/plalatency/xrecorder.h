@@ -0,0 +1,63 @@
+/**
+ * @file xrecorder.h
+ * @brief Watches an X display for key events using the XRecord extension.
+ */
+#ifndef XRECORDER_H
+#define XRECORDER_H
+
+#include <chrono>
+#include <functional>
+#include <string>
+#include <thread>
+
+typedef struct _XDisplay Display;
+
+/**
+ * @class XRecorder
+ * @brief Calls back for every key press and release the X server handles,
+ * from any client.
+ */
+class XRecorder
+{
+public:
+    /**
+     * @param keycode The X keycode
+     * @param press True for KeyPress, false for KeyRelease
+     * @param when When the event reached us
+     */
+    using Callback = std::function<void(unsigned int keycode, bool press,
+        std::chrono::steady_clock::time_point when)>;
+
+    XRecorder(void) = default;
+    ~XRecorder(void);
+
+    XRecorder(const XRecorder&) = delete;
+    XRecorder& operator=(const XRecorder&) = delete;
+
+    /**
+     * Starts recording on a background thread.
+     * @param display The display name, e.g. ":99"
+     * @param callback Called from the background thread for each event
+     * @return True if the display supports XRecord and recording started
+     */
+    bool start(const std::string& display, Callback callback);
+
+    /**
+     * Stops recording. Events still queued in the server are dropped.
+     */
+    void stop(void);
+
+    /**
+     * Tests if the display accepts connections.
+     */
+    static bool canConnect(const std::string& display);
+
+private:
+    Display *control = nullptr;
+    Display *data = nullptr;
+    unsigned long context = 0;
+    Callback callback;
+    std::thread worker;
+};
+
+#endif // XRECORDER_H
@@ -0,0 +1,122 @@
+/**
+ * @file main.cpp
+ * @brief Replays a controller input capture through the trackers, without a
+ * controller or display.
+ *
+ * Usage: plareplay [--realtime] [--profile FILE] [--keys FILE] CAPTURE
+ *
+ * Captures are made with "PLA_ALT --capture FILE". Actions come from the given
+ * profile (an .ini file from the profiles folder). The keystrokes produced are
+ * written one per line as "timestamp key modifiers press|release" to stdout,
+ * or to the --keys file. Replay statistics are written to stderr as
+ * "name value unit".
+ *
+ * Timed keys, such as proportional steering's pulses, are only produced with
+ * --realtime, since they run on the wall clock.
+ */
+#include "capture.h"
+#include "controller.h"
+#include "keybackend.h"
+#include "macro.h"
+#include "scheduler.h"
+
+#include <QCoreApplication>
+#include <QSettings>
+
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app (argc, argv);
+
+    bool realTime = false;
+    const char *profilePath = nullptr;
+    const char *keysPath = nullptr;
+    const char *capturePath = nullptr;
+
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--realtime") == 0) {
+            realTime = true;
+        } else if (hasValue && std::strcmp(argv[i], "--profile") == 0) {
+            profilePath = argv[++i];
+        } else if (hasValue && std::strcmp(argv[i], "--keys") == 0) {
+            keysPath = argv[++i];
+        } else if (capturePath == nullptr && argv[i][0] != '-') {
+            capturePath = argv[i];
+        } else {
+            capturePath = nullptr;
+            break;
+        }
+    }
+
+    if (capturePath == nullptr) {
+        std::cerr << "Usage: " << argv[0]
+            << " [--realtime] [--profile FILE] [--keys FILE] CAPTURE" << std::endl;
+        return 1;
+    }
+
+    ReplayInputSource source;
+    if (!source.open(capturePath, realTime)) {
+        std::cerr << "Unable to read capture " << capturePath << std::endl;
+        return 1;
+    }
+
+    if (profilePath != nullptr) {
+        QSettings profile (profilePath, QSettings::IniFormat);
+        if (profile.status() != QSettings::NoError) {
+            std::cerr << "Unable to read profile " << profilePath << std::endl;
+            return 1;
+        }
+
+        // Macros first, so keys bound to them are valid
+        Macro::load(profile);
+        Controller::load(profile);
+    }
+
+    RecordingKeyBackend keys;
+    KeyBackend::setCurrent(&keys);
+
+    if (realTime)
+        Scheduler::start();
+
+    unsigned long frames = 0;
+    InputFrame frame;
+    auto start = std::chrono::steady_clock::now();
+    while (source.read(frame)) {
+        keys.setTime(frame.timestamp);
+        // Live input follows the PG; a recording sets it
+        if (frame.pg != Controller::getPG())
+            Controller::selectPG(frame.pg);
+        Controller::process(frame);
+        frames++;
+    }
+    KeySender::finishMacros();
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    Scheduler::stop();
+    KeySender::stopMacros();
+
+    KeyBackend::setCurrent(nullptr);
+
+    if (keysPath != nullptr) {
+        std::ofstream out (keysPath);
+        if (!out.is_open()) {
+            std::cerr << "Unable to write " << keysPath << std::endl;
+            return 1;
+        }
+        keys.write(out);
+    } else {
+        keys.write(std::cout);
+    }
+
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+    std::cerr << "frames " << frames << " count\n"
+              << "key_events " << keys.events().size() << " count\n"
+              << "elapsed " << ns / 1e6 << " ms\n"
+              << "per_frame " << (frames > 0 ? ns / frames : 0) << " ns" << std::endl;
+    return 0;
+}
@@ -0,0 +1,20 @@
+#-------------------------------------------------
+#
+# Headless replay of controller input captures
+#
+#-------------------------------------------------
+
+QT += core gui concurrent
+
+TARGET = plareplay
+TEMPLATE = app
+
+CONFIG += console c++14 thread
+CONFIG -= app_bundle
+
+include(../../engine.pri)
+
+SOURCES += \
+    main.cpp
+
+QMAKE_CXXFLAGS += -Wall -Wextra -pedantic
@@ -0,0 +1,134 @@
+/**
+ * @file main.cpp
+ * @brief Measures Serial's command throughput and latency against the
+ * controller emulator.
+ *
+ * Usage: serialbench [--count N] [--delay-us N] [--drop RATE]
+ *
+ * Results are printed one per line as "name value unit".
+ */
+#include "emulator.h"
+#include "serial.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static double toMicros(Clock::duration d)
+{
+    return std::chrono::duration<double, std::micro>(d).count();
+}
+
+static void printLatency(const char *name, std::vector<double>& samples)
+{
+    if (samples.empty())
+        return;
+
+    std::sort(samples.begin(), samples.end());
+    auto at = [&](double q) {
+        return samples[static_cast<size_t>(q * (samples.size() - 1))];
+    };
+
+    std::cout << name << "_p50 " << at(0.5) << " us\n"
+              << name << "_p99 " << at(0.99) << " us\n"
+              << name << "_max " << samples.back() << " us\n";
+}
+
+int main(int argc, char *argv[])
+{
+    ControllerEmulator::Options opts;
+    int count = 1000;
+
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (hasValue && std::strcmp(argv[i], "--count") == 0) {
+            count = std::max(1, std::atoi(argv[++i]));
+        } else if (hasValue && std::strcmp(argv[i], "--delay-us") == 0) {
+            opts.delay = std::chrono::microseconds(std::atol(argv[++i]));
+        } else if (hasValue && std::strcmp(argv[i], "--drop") == 0) {
+            opts.dropRate = std::atof(argv[++i]);
+        } else {
+            std::cerr << "Usage: " << argv[0]
+                << " [--count N] [--delay-us N] [--drop RATE]" << std::endl;
+            return 1;
+        }
+    }
+
+    ControllerEmulator emulator (opts);
+    if (!emulator.start()) {
+        std::cerr << "Unable to create a pseudo-terminal." << std::endl;
+        return 1;
+    }
+
+    // Identification may be dropped too, so allow a few attempts
+    auto openStart = Clock::now();
+    bool opened = false;
+    for (int tries = 0; !opened && tries < 10; tries++)
+        opened = Serial::open(emulator.devicePath());
+    if (!opened) {
+        std::cerr << "Serial could not open " << emulator.devicePath() << std::endl;
+        return 1;
+    }
+    std::cout << "open " << toMicros(Clock::now() - openStart) << " us\n";
+
+    // 1. Color throughput: time to write, then time until the emulator has
+    //    handled everything that wasn't dropped.
+    {
+        auto before = emulator.stats();
+        auto start = Clock::now();
+        for (int i = 0; i < count; i++) {
+            auto v = static_cast<unsigned char>(i);
+            Serial::sendColor(v, v, v);
+        }
+        auto written = Clock::now();
+
+        auto deadline = written + std::chrono::seconds(5);
+        unsigned long handled = 0;
+        while (Clock::now() < deadline) {
+            auto now = emulator.stats();
+            handled = (now.color - before.color) + (now.dropped - before.dropped);
+            if (handled >= static_cast<unsigned long>(count))
+                break;
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+        auto done = Clock::now();
+
+        std::cout << "color_write_rate "
+                  << count / std::chrono::duration<double>(written - start).count()
+                  << " cmd/s\n"
+                  << "color_handled_rate "
+                  << handled / std::chrono::duration<double>(done - start).count()
+                  << " cmd/s\n";
+    }
+
+    // 2. PG query round trips, which wait on a reply
+    {
+        std::vector<double> samples;
+        samples.reserve(count);
+        int mismatches = 0;
+        for (int i = 0; i < count; i++) {
+            auto expected = static_cast<unsigned int>(i % 8);
+            Serial::setPg(expected);
+            auto start = Clock::now();
+            auto pg = Serial::getPg();
+            samples.push_back(toMicros(Clock::now() - start));
+            if (pg != static_cast<int>(expected))
+                mismatches++;
+        }
+
+        printLatency("getpg", samples);
+        std::cout << "getpg_mismatch " << mismatches << " count\n";
+    }
+
+    Serial::close();
+    emulator.stop();
+
+    auto s = emulator.stats();
+    std::cout << "emulator_dropped " << s.dropped << " count" << std::endl;
+    return 0;
+}
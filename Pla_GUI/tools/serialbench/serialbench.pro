@@ -0,0 +1,26 @@
+#-------------------------------------------------
+#
+# Serial throughput/latency benchmark, run against plaemu
+#
+#-------------------------------------------------
+
+TARGET = serialbench
+TEMPLATE = app
+
+CONFIG += console c++14 thread
+CONFIG -= qt app_bundle
+
+INCLUDEPATH += ../.. ../plaemu
+
+SOURCES += \
+    main.cpp \
+    ../plaemu/emulator.cpp \
+    ../../serial.cpp \
+    ../../trace.cpp
+
+HEADERS += \
+    ../plaemu/emulator.h \
+    ../../serial.h \
+    ../../trace.h
+
+QMAKE_CXXFLAGS += -Wall -Wextra -pedantic
@@ -0,0 +1,11 @@
+# Developer tools for the PLA ALT input engine.
+# These are Linux-only and are not needed to build or run PLA_ALT.
+# Programs that use the input engine need Qt, SDL2 and libxdo, like PLA_ALT.
+
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    plaemu \
+    plalatency \
+    plareplay \
+    serialbench
@@ -0,0 +1,209 @@
+#include "trace.h"
+
+#include "config.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+struct TraceEvent {
+    const char *category;
+    const char *name;
+    std::int64_t start;
+    std::int64_t end;
+};
+
+/**
+ * One thread's events. The owning thread is the only writer; the lock is
+ * only ever contended while a trace is being written out or cleared.
+ */
+struct ThreadBuffer {
+    ThreadBuffer(int id) :
+        id(id),
+        events(config::TraceEventsPerThread) {}
+
+    int id;
+    const char *name = nullptr;
+    bool retired = false;
+
+    std::mutex lock;
+    std::vector<TraceEvent> events;
+    std::uint64_t written = 0;
+};
+
+std::mutex registryLock;
+std::vector<std::shared_ptr<ThreadBuffer>> registry;
+int nextThreadId = 1;
+
+/**
+ * Keeps a thread's buffer, and marks it retired when the thread exits so
+ * threads that come and go don't pile up buffers.
+ */
+struct ThreadBufferHolder {
+    std::shared_ptr<ThreadBuffer> buffer;
+
+    ~ThreadBufferHolder(void) {
+        if (buffer) {
+            std::lock_guard<std::mutex> guard (registryLock);
+            buffer->retired = true;
+        }
+    }
+};
+
+thread_local ThreadBufferHolder localBuffer;
+// Kept apart from the buffer, so naming a thread doesn't allocate one
+thread_local const char *localName = nullptr;
+
+ThreadBuffer& threadBuffer(void)
+{
+    if (!localBuffer.buffer) {
+        std::lock_guard<std::mutex> guard (registryLock);
+
+        // Forget the oldest exited threads
+        unsigned int retired = 0;
+        for (const auto& b : registry)
+            retired += b->retired ? 1 : 0;
+        for (auto it = registry.begin();
+             retired > config::TraceRetiredThreads && it != registry.end();) {
+            if ((*it)->retired) {
+                it = registry.erase(it);
+                retired--;
+            } else {
+                ++it;
+            }
+        }
+
+        localBuffer.buffer = std::make_shared<ThreadBuffer>(nextThreadId++);
+        localBuffer.buffer->name = localName;
+        registry.push_back(localBuffer.buffer);
+    }
+
+    return *localBuffer.buffer;
+}
+
+void writeString(std::ostream& out, const char *str)
+{
+    out << '"';
+    for (; *str != '\0'; str++) {
+        if (*str == '"' || *str == '\\')
+            out << '\\';
+        out << *str;
+    }
+    out << '"';
+}
+
+} // namespace
+
+std::atomic_bool Trace::enabled (false);
+
+void Trace::setEnabled(bool enable)
+{
+    enabled.store(enable);
+}
+
+void Trace::setThreadName(const char *name)
+{
+    // The buffer takes the name when tracing first records on this thread
+    localName = name;
+    if (localBuffer.buffer) {
+        std::lock_guard<std::mutex> guard (localBuffer.buffer->lock);
+        localBuffer.buffer->name = name;
+    }
+}
+
+std::int64_t Trace::now(void)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Trace::record(const char *category, const char *name,
+    std::int64_t start, std::int64_t end)
+{
+    if (!isEnabled())
+        return;
+
+    auto& buffer = threadBuffer();
+    std::lock_guard<std::mutex> guard (buffer.lock);
+    buffer.events[buffer.written % buffer.events.size()] = {category, name, start, end};
+    buffer.written++;
+}
+
+void Trace::clear(void)
+{
+    std::lock_guard<std::mutex> guard (registryLock);
+    for (auto& b : registry) {
+        std::lock_guard<std::mutex> bufferGuard (b->lock);
+        b->written = 0;
+    }
+}
+
+void Trace::write(std::ostream& out)
+{
+    // Times are written in microseconds, relative to the first event
+    std::vector<std::pair<std::shared_ptr<ThreadBuffer>, std::vector<TraceEvent>>> copies;
+    std::int64_t origin = 0;
+    {
+        std::lock_guard<std::mutex> guard (registryLock);
+        for (auto& b : registry) {
+            std::lock_guard<std::mutex> bufferGuard (b->lock);
+            auto size = b->events.size();
+            auto count = std::min<std::uint64_t>(b->written, size);
+
+            std::vector<TraceEvent> events;
+            events.reserve(count);
+            for (auto i = b->written - count; i < b->written; i++)
+                events.push_back(b->events[i % size]);
+
+            if (!events.empty() && (origin == 0 || events.front().start < origin))
+                origin = events.front().start;
+            copies.emplace_back(b, std::move(events));
+        }
+    }
+
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    bool first = true;
+    auto separator = [&] {
+        if (!first)
+            out << ",\n";
+        first = false;
+    };
+
+    for (const auto& c : copies) {
+        if (c.first->name != nullptr) {
+            separator();
+            out << "{\"ph\":\"M\",\"pid\":1,\"tid\":" << c.first->id
+                << ",\"name\":\"thread_name\",\"args\":{\"name\":";
+            writeString(out, c.first->name);
+            out << "}}";
+        }
+
+        for (const auto& e : c.second) {
+            separator();
+            out << "{\"ph\":\"X\",\"pid\":1,\"tid\":" << c.first->id << ",\"cat\":";
+            writeString(out, e.category);
+            out << ",\"name\":";
+            writeString(out, e.name);
+            out << ",\"ts\":" << (e.start - origin) / 1000.
+                << ",\"dur\":" << (e.end - e.start) / 1000. << '}';
+        }
+    }
+
+    out << "]}\n";
+    out.flush();
+}
+
+bool Trace::write(const char *path)
+{
+    std::ofstream file (path);
+    if (!file.is_open())
+        return false;
+
+    write(file);
+    return file.good();
+}
@@ -0,0 +1,108 @@
+/**
+ * @file trace.h
+ * @brief Records timed events that can be viewed in Chrome's about:tracing
+ * or in Perfetto.
+ */
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+
+/**
+ * @class Trace
+ * @brief Collects "complete" trace events into per-thread ring buffers.
+ *
+ * Each thread writes only to its own buffer, so recording never contends with
+ * other threads. Once a buffer is full the oldest events are overwritten.
+ * Event names and categories must be string literals (they are stored as
+ * pointers, not copied).
+ *
+ * While disabled, recording returns after a single relaxed load.
+ */
+class Trace
+{
+public:
+    static void setEnabled(bool enable);
+    inline static bool isEnabled(void) {
+        return enabled.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Names the calling thread in written traces.
+     * @param name A string literal
+     */
+    static void setThreadName(const char *name);
+
+    /**
+     * Records an event that ran from start to end.
+     * @param category Event category, e.g. "input"
+     * @param name Event name
+     * @param start Start time, in steady_clock nanoseconds
+     * @param end End time, in steady_clock nanoseconds
+     */
+    static void record(const char *category, const char *name,
+        std::int64_t start, std::int64_t end);
+
+    /**
+     * Gets the current time, as used for record().
+     */
+    static std::int64_t now(void);
+
+    /**
+     * Drops all recorded events.
+     */
+    static void clear(void);
+
+    /**
+     * Writes all recorded events as trace-event JSON.
+     */
+    static void write(std::ostream& out);
+
+    /**
+     * Writes all recorded events as trace-event JSON to a file.
+     * @return True if success
+     */
+    static bool write(const char *path);
+
+private:
+    static std::atomic_bool enabled;
+};
+
+/**
+ * @class TraceScope
+ * @brief Records an event lasting for the lifetime of the object.
+ */
+class TraceScope
+{
+public:
+    TraceScope(const char *category, const char *name) :
+        category(category),
+        name(name),
+        start(Trace::isEnabled() ? Trace::now() : 0) {}
+
+    ~TraceScope(void) {
+        if (start != 0)
+            Trace::record(category, name, start, Trace::now());
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char *category;
+    const char *name;
+    std::int64_t start;
+};
+
+#define PLA_TRACE_CONCAT2(a, b) a##b
+#define PLA_TRACE_CONCAT(a, b) PLA_TRACE_CONCAT2(a, b)
+
+/**
+ * Traces the rest of the enclosing scope.
+ */
+#define PLA_TRACE_SCOPE(category, name) \
+    TraceScope PLA_TRACE_CONCAT(traceScope, __LINE__) (category, name)
+
+#endif // TRACE_H
@@ -1,6 +1,8 @@
 #include "wheeltab.h"
+#include "assets.h"
 #include "controller.h"
 #include "profile.h"
+#include "trace.h"
 
 #include <QPainter>
 
@@ -9,6 +11,7 @@ WheelTab::WheelTab(QWidget *parent) :
     lLeftAction("WHEEL LEFT", this),
     lRightAction("WHEEL RIGHT", this),
     steerDigital("DIGITAL STEERING", this),
+    steerProportional("PROPORTIONAL STEERING", this),
     steerAnalog("ANALOG STEERING", this),
     keyGrabber(this),
     leftAction("", this),
@@ -17,15 +20,17 @@ WheelTab::WheelTab(QWidget *parent) :
     configCancel("CANCEL", this),
     configThreshold("TRIGGER SETTINGS", this),
     steerData(Controller::Steering),
-    thresholdDialog(this, parent)
+    thresholdDialog(this, parent),
+    background(Assets::pixmap("wheelbg.png"))
 {
     // Set geometries
     lLeftAction.setGeometry(70, 40, 90, 20);
     lRightAction.setGeometry(190, 40, 90, 20);
     leftAction.setGeometry(70, 60, 90, 30);
     rightAction.setGeometry(190, 60, 90, 30);
-    steerDigital.setGeometry(70, 105, 210, 30);
-    steerAnalog.setGeometry(70, 150, 210, 30);
+    steerDigital.setGeometry(70, 100, 210, 30);
+    steerProportional.setGeometry(70, 130, 210, 30);
+    steerAnalog.setGeometry(70, 160, 210, 30);
     configThreshold.setGeometry(70, 190, 170, 20);
     configSave.setGeometry(70, 220, 80, 20);
     configCancel.setGeometry(160, 220, 80, 20);
@@ -40,7 +45,9 @@ WheelTab::WheelTab(QWidget *parent) :
     connect(&leftAction, SIGNAL(released()), this, SLOT(assignLeft()));
     connect(&rightAction, SIGNAL(released()), this, SLOT(assignRight()));
     connect(&keyGrabber, SIGNAL(keyPressed(Key)), this, SLOT(keyPressed(Key)));
-    connect(&steerDigital, SIGNAL(toggled(bool)), this, SLOT(setWheelFunction(bool)));
+    connect(&steerDigital, SIGNAL(toggled(bool)), this, SLOT(setWheelFunction()));
+    connect(&steerProportional, SIGNAL(toggled(bool)), this, SLOT(setWheelFunction()));
+    connect(&steerAnalog, SIGNAL(toggled(bool)), this, SLOT(setWheelFunction()));
     connect(&configSave, SIGNAL(released()), this, SLOT(saveSettings()));
     connect(&configCancel, SIGNAL(released()), this, SLOT(loadSettings()));
     connect(&configThreshold, SIGNAL(released()), this, SLOT(openThresholdSettings()));
@@ -56,10 +63,19 @@ void WheelTab::showEvent(QShowEvent *event)
     leftAction.setToolTip(leftAction.text());
     rightAction.setToolTip(rightAction.text());
 
-    // Set digital/analog
-    bool digital = steerData->getDigital();
-    (digital ? steerDigital : steerAnalog).setChecked(true);
-    setWheelFunction(digital);
+    // Set digital/proportional/analog
+    switch (steerData->getMode()) {
+    case SteeringTracker::Digital:
+        steerDigital.setChecked(true);
+        break;
+    case SteeringTracker::Proportional:
+        steerProportional.setChecked(true);
+        break;
+    default:
+        steerAnalog.setChecked(true);
+        break;
+    }
+    setWheelFunction();
 
     if (event != nullptr)
         event->accept();
@@ -67,9 +83,9 @@ void WheelTab::showEvent(QShowEvent *event)
 
 void WheelTab::paintEvent(QPaintEvent *event)
 {
-    static QImage background ("assets/wheelbg.png");
+    PLA_TRACE_SCOPE("gui", "WheelTab::paintEvent");
     QPainter paint (this);
-    paint.drawImage(0, 10, background);
+    paint.drawPixmap(0, 10, background);
 
     if (event != nullptr)
         event->accept();
@@ -94,15 +110,23 @@ void WheelTab::saveSettings(void)
     Controller::save(Profile::current());
 }
 
-void WheelTab::setWheelFunction(bool digital)
+void WheelTab::setWheelFunction(void)
 {
-    // Make buttons visible if in digital mode
-    lLeftAction.setVisible(digital);
-    lRightAction.setVisible(digital);
-    leftAction.setVisible(digital);
-    rightAction.setVisible(digital);
-
-    steerData->setDigital(digital);
+    auto mode = SteeringTracker::Analog;
+    if (steerDigital.isChecked())
+        mode = SteeringTracker::Digital;
+    else if (steerProportional.isChecked())
+        mode = SteeringTracker::Proportional;
+
+    // Make buttons visible if the wheel sends keys
+    bool keys = mode != SteeringTracker::Analog;
+    lLeftAction.setVisible(keys);
+    lRightAction.setVisible(keys);
+    leftAction.setVisible(keys);
+    rightAction.setVisible(keys);
+
+    if (steerData->getMode() != mode)
+        steerData->setMode(mode);
 }
 
 void WheelTab::assignLeft(void)
@@ -11,6 +11,7 @@
 #include "steeringtracker.h"
 #include "wheelthresholdsetter.h"
 
+#include <QPixmap>
 #include <QPushButton>
 #include <QRadioButton>
 #include <QShowEvent>
@@ -46,9 +47,9 @@ private slots:
     void keyPressed(Key key);
 
     /**
-     * Catches change in digital/analog selection.
+     * Catches change in digital/proportional/analog selection.
      */
-    void setWheelFunction(bool digital);
+    void setWheelFunction(void);
 
     /**
      * Save all settings.
@@ -73,6 +74,7 @@ private:
     QLabel lRightAction;
 
     QRadioButton steerDigital;
+    QRadioButton steerProportional;
     QRadioButton steerAnalog;
 
     KeyGrabber keyGrabber;
@@ -85,6 +87,7 @@ private:
 
     Editing<SteeringTracker> steerData;
     WheelThresholdSetter thresholdDialog;
+    QPixmap background;
 
     int activeAction;
 };
@@ -55,7 +55,7 @@ void WheelThresholdSetter::showEvent(QShowEvent *event)
         Controller::setEnabled(true);
         Controller::setOperating(false);
         while (shouldUpdate) {
-            position = Controller::Steering.getPosition();
+            position = Controller::snapshot().wheel;
             updateMap();
             QThread::msleep(100);
         }